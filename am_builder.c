@@ -1,194 +1,555 @@
-/*
- * This code includes functions that manipulate macro lists and build an assembly language file (.am) based on a given assembly file (.as).
- * The code handles macro definitions, macro calls, and error checking.
- */
-
-#include <malloc.h>
-#include "am_builder.h"
-#include "string.h"
-#include "ctype.h"
-#include <stdio.h>
-#include <stdlib.h>
-
-/*
- * Function: is_empty_row
- * ----------------------
- * Checks if a given string represents an empty row.
- *
- * str: The string to check.
- *
- * returns: True if the string is empty or contains only whitespace characters, False otherwise.
- */
-bool is_empty_row(char str[]) {
-    int i = 0;
-    for (; i < strlen(str); ++i) {
-        if (!isspace(str[i]))
-            return false;
-    }
-    return true;
-}
-
-/*
- * Function: write_to_am_file
- * --------------------------
- * Writes a line to the .am file, either as it is or by expanding a macro.
- *
- * as_file: The .as file being processed.
- * am_file: The .am file to write to.
- * mcro_list: The list of macros.
- * line: The line to write.
- */
-void write_to_am_file(FILE *am_file, struct mcro_list *mcro_list, char line[]) {
-    struct mcro_list *current = NULL;
-    struct mcro mcro;
-    bool is_mcro = false;
-    int i;
-
-    if (strlen(line) == 0 || line[0] == ';' || is_empty_row(line)) {
-        /* Ignore empty lines or comments */
-    } else {
-        current = mcro_list;
-        while (current != NULL) {
-            i = 0;
-            if (strcmp(line, current->data.mcro_name) == 0) {
-                mcro = current->data;
-                is_mcro = true;
-                for (; i < mcro.code_lines_count; ++i) {
-                    fprintf(am_file, "%s", mcro.code_lines[i]);
-                }
-                break;
-            }
-            current = current->next;
-        }
-
-        if (!is_mcro) {
-            fprintf(am_file, "%s", line);
-        }
-    }
-}
-
-/*
- * Function: make_mcro_list_and_am_file
- * ------------------------------------
- * Creates a list of macros and builds the .am file based on the .as file.
- *
- * as_file: The .as file.
- * am_file: The .am file to create.
- * mcro_list: Pointer to the list of macros.
- */
-void make_mcro_list_and_am_file(FILE *as_file, FILE *am_file, struct mcro_list** mcro_list) {
-    char line[MAX_LINE_SIZE] = "aa";
-    struct mcro_list* current_mcro = NULL;
-    int row_index = 0;
-    char temp[MAX_LABEL_SIZE];
-
-    while (fgets(line, sizeof(line), as_file) != NULL) {
-        /* Check if line starts with "mcro" */
-        if (strncmp(line, "mcro", 4) == 0) {
-            /* Create a new mcro node */
-            struct mcro_list* new_mcro = (struct mcro_list*)malloc(sizeof(struct mcro_list));
-            strcpy(new_mcro->data.mcro_name, line + 5);
-            new_mcro->data.code_lines_count = 0;
-            new_mcro->next = NULL;
-
-            strncpy(temp, new_mcro->data.mcro_name, strlen(new_mcro->data.mcro_name) - 1);
-            if (!is_not_equal_to_reserved_word(temp)) {
-                printf("as - %d: ERROR MACRO NAME IS ILLEGAL\n", row_index);
-            }
-
-            /* Add mcro to the mcro_list */
-            if (*mcro_list == NULL) {
-                *mcro_list = new_mcro;
-                current_mcro = *mcro_list;
-            } else {
-                current_mcro->next = new_mcro;
-                current_mcro = current_mcro->next;
-            }
-
-            /* Read code lines until "endmcro" is reached */
-            while (fgets(line, sizeof(line), as_file) != NULL) {
-                if (strncmp(line, "endmcro", 6) == 0) {
-                    break;
-                }
-
-                /* Add code line to mcro */
-                strcpy(current_mcro->data.code_lines[current_mcro->data.code_lines_count], line);
-                current_mcro->data.code_lines_count++;
-            }
-        } else {
-            /* Check if the line is a macro call */
-            write_to_am_file(am_file, *mcro_list, line);
-        }
-        row_index++;
-    }
-}
-
-/*
- * Function: is_mcro_error
- * -----------------------
- * Checks if there is a macro call before its declaration in the .am file.
- *
- * am_file: The .am file.
- * mcro_list: The list of macros.
- */
-void is_mcro_error(FILE *am_file, struct mcro_list *mcro_list) {
-    char line[MAX_LINE_SIZE];
-    int row_index = 0;
-
-    while (fgets(line, sizeof(line), am_file) != NULL) {
-        struct mcro_list *current = mcro_list;
-        while (current != NULL){
-            if(strcmp(line, current->data.mcro_name) == 0){
-                printf("am - %d: ERROR MACRO CALLING BEFORE DECLARATION\n", row_index);
-                break;
-            }
-            current = current->next;
-        }
-        row_index++;
-    }
-}
-
-/*
- * Function: am_builder
- * --------------------
- * Builds the .am file based on the given .as file.
- *
- * as_file: The .as file.
- */
-void am_builder(struct file_struct *as_file) {
-    struct mcro_list* mcro_list = NULL;
-    struct mcro_list* current_mcro = NULL;
-    struct mcro_list* temp = NULL;
-    int i;
-    struct file_struct *am_file = malloc(sizeof(struct file_struct));
-
-    strcpy(am_file->name, as_file->name);
-    am_file->name[strlen(am_file->name) - 1] = 'm';
-    am_file->file = fopen(am_file->name, "w+");
-    if (am_file->file == NULL) {
-        printf("fail\n");
-        exit(-1);
-    }
-
-    make_mcro_list_and_am_file(as_file->file, am_file->file, &mcro_list);
-
-    fclose(am_file->file);
-    am_file->file = fopen(am_file->name, "r");
-    if (am_file->file == NULL) {
-        printf("fail\n");
-    }
-
-    is_mcro_error(am_file->file, mcro_list);
-
-    current_mcro = mcro_list;
-    while (current_mcro != NULL) {
-        for (i = 0; i < current_mcro->data.code_lines_count; i++) {
-            free(current_mcro->data.code_lines[i]);
-        }
-        temp = current_mcro;
-        current_mcro = current_mcro->next;
-        free(temp);
-    }
-    fclose(am_file->file);
-    free(am_file);
-}
+/*
+ * This code includes functions that manipulate macro lists and build an assembly language file (.am) based on a given assembly file (.as).
+ * The code handles macro definitions, macro calls, and error checking.
+ * The expanded lines are kept in memory (struct am_source), the .am file itself is written only on request.
+ * The macros (table, names, bodies and the syntax trees of their lines) live in the arena of the expanded source.
+ * Each macro body is lexed once when it is declared, and every call of the macro reuses the syntax trees.
+ */
+
+#include <malloc.h>
+#include "am_builder.h"
+#include "string.h"
+#include "ctype.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Function: is_empty_row
+ * ----------------------
+ * Checks if a given line represents an empty row.
+ *
+ * str: The line to check.
+ * length: The length of the line.
+ *
+ * returns: True if the line is empty or contains only whitespace characters, False otherwise.
+ */
+static bool is_empty_row(const char *str, int length) {
+    int i = 0;
+    for (; i < length; ++i) {
+        if (!isspace(str[i]))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Function: reserve_am_text
+ * -------------------------
+ * Makes sure the text of the expanded source has room for more characters (and the null terminator).
+ *
+ * am: The expanded source.
+ * extra: The number of characters to add.
+ */
+static void reserve_am_text(struct am_source *am, int extra) {
+    if (am->text_length + extra + 1 > am->text_capacity) {
+        char *grown;
+
+        while (am->text_length + extra + 1 > am->text_capacity) {
+            am->text_capacity = am->text_capacity == 0 ? 1024 : am->text_capacity * 2;
+        }
+        grown = (char *) realloc(am->text, am->text_capacity);
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        am->text = grown;
+    }
+}
+
+/*
+ * Function: add_am_line_start
+ * ---------------------------
+ * Records the start of a new line of the expanded source.
+ *
+ * am: The expanded source.
+ * offset: The offset of the line in the text.
+ * tree: The pre-built syntax tree of the line, or NULL.
+ */
+static void add_am_line_start(struct am_source *am, int offset, const struct syntax_tree *tree) {
+    if (am->lines_count == am->lines_capacity) {
+        int *grown_starts;
+        const struct syntax_tree **grown_trees;
+
+        am->lines_capacity = am->lines_capacity == 0 ? 64 : am->lines_capacity * 2;
+        grown_starts = (int *) realloc(am->line_starts, am->lines_capacity * sizeof(int));
+        if (grown_starts == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        am->line_starts = grown_starts;
+        grown_trees = (const struct syntax_tree **) realloc(am->line_trees,
+                                                            am->lines_capacity * sizeof(struct syntax_tree *));
+        if (grown_trees == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        am->line_trees = grown_trees;
+    }
+    am->line_starts[am->lines_count] = offset;
+    am->line_trees[am->lines_count] = tree;
+    am->lines_count++;
+}
+
+/*
+ * Function: is_at_line_start
+ * --------------------------
+ * Checks if the next character appended to the expanded source starts a new line.
+ */
+static bool is_at_line_start(const struct am_source *am) {
+    return am->text_length == 0 || am->text[am->text_length - 1] == '\n';
+}
+
+/*
+ * Function: append_to_am_source
+ * -----------------------------
+ * Appends a line of the source to the in-memory expanded source.
+ *
+ * am: The expanded source.
+ * str: The line to append.
+ * length: The length of the line, including its '\n'.
+ */
+static void append_to_am_source(struct am_source *am, const char *str, int length) {
+    reserve_am_text(am, length);
+
+    /* A line starts at the beginning of the text or right after '\n' */
+    if (is_at_line_start(am)) {
+        add_am_line_start(am, am->text_length, NULL);
+    }
+    memcpy(am->text + am->text_length, str, length);
+    am->text_length += length;
+    am->text[am->text_length] = '\0';
+}
+
+/*
+ * Function: am_source_line_length
+ * -------------------------------
+ * Returns the length of a line of the expanded source, including its '\n' (if it has one).
+ *
+ * am: The expanded source.
+ * index: The index of the line.
+ */
+int am_source_line_length(const struct am_source *am, int index) {
+    int end = index + 1 < am->lines_count ? am->line_starts[index + 1] : am->text_length;
+    return end - am->line_starts[index];
+}
+
+/*
+ * Function: get_first_token
+ * -------------------------
+ * Finds the first token (word) of a line.
+ *
+ * line: The line.
+ * line_length: The length of the line.
+ * token: Pointer to store the start of the token.
+ *
+ * returns: The length of the token, 0 if the line is empty.
+ */
+static int get_first_token(const char *line, int line_length, const char **token) {
+    int i = 0, length = 0;
+
+    while (i < line_length && line[i] != '\n' && isspace(line[i])) {
+        i++;
+    }
+    while (i + length < line_length && !isspace(line[i + length])) {
+        length++;
+    }
+
+    *token = line + i;
+    return length;
+}
+
+/*
+ * Function: is_single_token_line
+ * ------------------------------
+ * Checks if a line holds exactly one token, this is the form of a macro call.
+ * The line ends with '\n' or at its length.
+ *
+ * line: The line.
+ * line_length: The length of the line.
+ * token: Pointer to store the start of the token.
+ *
+ * returns: The length of the token, or 0 if the line doesn't hold exactly one token.
+ */
+static int is_single_token_line(const char *line, int line_length, const char **token) {
+    int length = get_first_token(line, line_length, token);
+    int i = *token + length - line;
+
+    while (i < line_length && line[i] != '\n' && isspace(line[i])) {
+        i++;
+    }
+    if (length == 0 || (i < line_length && line[i] != '\n')) {
+        return 0;
+    }
+    return length;
+}
+
+/*
+ * Function: get_mcro
+ * ------------------
+ * Looks up a macro in the macro table.
+ *
+ * table: The macro table.
+ * name: The name of the macro (doesn't have to be null terminated).
+ * length: The length of the name.
+ *
+ * returns: The macro, or NULL if there is no macro with this name.
+ */
+static struct mcro *get_mcro(const struct mcro_table *table, const char *name, int length) {
+    struct mcro_list *current;
+
+    if (table->buckets_count == 0) {
+        return NULL;
+    }
+
+    current = table->buckets[hash_string(name, length) & (table->buckets_count - 1)];
+    while (current != NULL) {
+        if (strncmp(current->data.mcro_name, name, length) == 0 && current->data.mcro_name[length] == '\0') {
+            return &current->data;
+        }
+        current = current->next;
+    }
+    return NULL;
+}
+
+/*
+ * Function: add_mcro
+ * ------------------
+ * Adds a macro to the macro table, the table grows when it has more macros than buckets.
+ * The buckets are taken from the arena, an old bucket array is released with the rest of the arena.
+ *
+ * table: The macro table.
+ * new_mcro: The macro node to add.
+ */
+static void add_mcro(struct mcro_table *table, struct mcro_list *new_mcro) {
+    struct mcro_list **buckets, *current, *next;
+    int buckets_count, i;
+    unsigned long index;
+
+    if (table->mcro_count >= table->buckets_count) {
+        buckets_count = table->buckets_count == 0 ? 64 : table->buckets_count * 2;
+        buckets = (struct mcro_list **) arena_alloc(table->arena, buckets_count * sizeof(struct mcro_list *));
+        memset(buckets, 0, buckets_count * sizeof(struct mcro_list *));
+
+        for (i = 0; i < table->buckets_count; ++i) {
+            for (current = table->buckets[i]; current != NULL; current = next) {
+                next = current->next;
+                index = hash_string(current->data.mcro_name, strlen(current->data.mcro_name)) & (buckets_count - 1);
+                current->next = buckets[index];
+                buckets[index] = current;
+            }
+        }
+
+        table->buckets = buckets;
+        table->buckets_count = buckets_count;
+    }
+
+    index = hash_string(new_mcro->data.mcro_name, strlen(new_mcro->data.mcro_name)) & (table->buckets_count - 1);
+    new_mcro->next = table->buckets[index];
+    table->buckets[index] = new_mcro;
+    table->mcro_count++;
+}
+
+/*
+ * Function: add_mcro_candidate
+ * ----------------------------
+ * Records a line of the expanded source that looks like a macro call of an unknown macro.
+ * If a macro with this name is declared later, it is a call before the declaration.
+ *
+ * candidates: The recorded candidates.
+ * row_index: The index of the line in the expanded source.
+ */
+static void add_mcro_candidate(struct mcro_candidates *candidates, int row_index) {
+    if (candidates->count == candidates->capacity) {
+        int *grown;
+
+        candidates->capacity = candidates->capacity == 0 ? 64 : candidates->capacity * 2;
+        grown = (int *) realloc(candidates->rows, candidates->capacity * sizeof(int));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        candidates->rows = grown;
+    }
+    candidates->rows[candidates->count++] = row_index;
+}
+
+/*
+ * Function: append_mcro
+ * ---------------------
+ * Expands a macro into the expanded source: the body is copied with a single memcpy,
+ * and the lines (with their syntax trees) are taken from the line index of the macro.
+ *
+ * am: The expanded source.
+ * candidates: The recorded macro call candidates.
+ * mcro: The macro to expand.
+ */
+static void append_mcro(struct am_source *am, struct mcro_candidates *candidates, const struct mcro *mcro) {
+    int base = am->text_length, i = 0;
+
+    /* If the last line wasn't closed, the first line of the body continues it */
+    if (mcro->code_lines_count > 0 && !is_at_line_start(am)) {
+        i++;
+    }
+    for (; i < mcro->code_lines_count; ++i) {
+        if (mcro->lines[i].is_call_candidate) {
+            add_mcro_candidate(candidates, am->lines_count);
+        }
+        add_am_line_start(am, base + mcro->lines[i].offset, mcro->lines[i].tree);
+    }
+
+    reserve_am_text(am, mcro->body_length);
+    memcpy(am->text + base, mcro->body, mcro->body_length);
+    am->text_length += mcro->body_length;
+    am->text[am->text_length] = '\0';
+}
+
+/*
+ * Function: write_to_am_file
+ * --------------------------
+ * Writes a line to the expanded source, either as it is or by expanding a macro.
+ *
+ * am: The expanded source to write to.
+ * table: The macro table.
+ * candidates: The recorded macro call candidates.
+ * line: The line to write.
+ * line_length: The length of the line, including its '\n'.
+ */
+void write_to_am_file(struct am_source *am, const struct mcro_table *table, struct mcro_candidates *candidates,
+                      const char *line, int line_length) {
+    struct mcro *mcro = NULL;
+    const char *token;
+    int length;
+
+    if (is_empty_row(line, line_length)) {
+        /* Ignore empty lines (comments are skipped by the caller) */
+    } else {
+        length = is_single_token_line(line, line_length, &token);
+        if (length != 0) {
+            mcro = get_mcro(table, token, length);
+        }
+
+        if (mcro != NULL) {
+            append_mcro(am, candidates, mcro);
+        } else {
+            if (length != 0 && is_at_line_start(am)) {
+                add_mcro_candidate(candidates, am->lines_count);
+            }
+            append_to_am_source(am, line, line_length);
+        }
+    }
+}
+
+/*
+ * Function: index_mcro_lines
+ * --------------------------
+ * Builds the line index of a macro body: where each line starts, if it looks like a macro call,
+ * and its syntax tree, so the body is lexed and validated only once.
+ *
+ * table: The table of the macros, its arena and the pool of the label names.
+ * mcro: The macro, its body is already set.
+ * source: The source file.
+ * first_line: The index of the first line of the body in the source.
+ */
+static void index_mcro_lines(struct mcro_table *table, struct mcro *mcro, const struct source_file *source,
+                             int first_line) {
+    const char *token;
+    int i = 0, offset, length;
+
+    mcro->lines = (struct mcro_line *) arena_alloc(table->arena, mcro->code_lines_count * sizeof(struct mcro_line));
+
+    for (; i < mcro->code_lines_count; ++i) {
+        offset = source->line_starts[first_line + i] - source->line_starts[first_line];
+        length = source_line_length(source, first_line + i);
+
+        mcro->lines[i].offset = offset;
+        mcro->lines[i].is_call_candidate = is_single_token_line(mcro->body + offset, length, &token) != 0;
+        mcro->lines[i].tree = NULL;
+
+        /* Lines that are too long are left to the first pass, which reports them */
+        if (length - (mcro->body[offset + length - 1] == '\n') < MAX_LINE_SIZE) {
+            mcro->lines[i].tree = (struct syntax_tree *) arena_alloc(table->arena, sizeof(struct syntax_tree));
+            build_syntax_tree_from_line(mcro->lines[i].tree, mcro->body + offset, length, table->names);
+        }
+    }
+}
+
+/*
+ * Function: is_comment_line
+ * -------------------------
+ * Checks if a line of the source is a comment, using the comment index of the source.
+ *
+ * source: The source file.
+ * comment_index: Pointer to the next comment in the index, it is advanced past the line.
+ * line_index: The index of the line, the lines are checked in increasing order.
+ */
+static bool is_comment_line(const struct source_file *source, int *comment_index, int line_index) {
+    while (*comment_index < source->comments_count &&
+           source->comment_starts[*comment_index] < source->line_starts[line_index]) {
+        (*comment_index)++;
+    }
+    return *comment_index < source->comments_count &&
+           source->comment_starts[*comment_index] == source->line_starts[line_index];
+}
+
+/*
+ * Function: make_mcro_list_and_am_file
+ * ------------------------------------
+ * Creates the table of macros and builds the expanded source based on the .as file.
+ * The body of each macro is copied at once from the source to the arena of the table.
+ *
+ * source: The .as file.
+ * am: The expanded source to build.
+ * table: The macro table.
+ * candidates: The recorded macro call candidates.
+ */
+void make_mcro_list_and_am_file(const struct source_file *source, struct am_source *am, struct mcro_table *table,
+                                struct mcro_candidates *candidates) {
+    struct mcro_list* current_mcro = NULL;
+    int row_index = 0, line_index = 0, comment_index = 0, end_line, length, body_start, body_end;
+    const char *line, *token;
+
+    for (; line_index < source->lines_count; line_index++, row_index++) {
+        line = source->data + source->line_starts[line_index];
+        length = source_line_length(source, line_index);
+
+        if (is_comment_line(source, &comment_index, line_index)) {
+            continue;
+        }
+
+        /* Check if line starts with "mcro" */
+        if (length >= 4 && strncmp(line, "mcro", 4) == 0) {
+            /* Create a new mcro node */
+            current_mcro = (struct mcro_list*) arena_alloc(table->arena, sizeof(struct mcro_list));
+            current_mcro->next = NULL;
+
+            length = get_first_token(line + 4, length - 4, &token);
+            if (length >= MAX_LABEL_SIZE) {
+                length = MAX_LABEL_SIZE - 1;
+            }
+            strncpy(current_mcro->data.mcro_name, token, length);
+            current_mcro->data.mcro_name[length] = '\0';
+
+            if (!is_not_equal_to_reserved_word(current_mcro->data.mcro_name)) {
+                report_line_error(table->diagnostics, "as - ", row_index, "ERROR MACRO NAME IS ILLEGAL");
+            }
+
+            /* Find the "endmcro" line, the lines in between are the body */
+            for (end_line = line_index + 1; end_line < source->lines_count; end_line++) {
+                if (source_line_length(source, end_line) >= 6 &&
+                    strncmp(source->data + source->line_starts[end_line], "endmcro", 6) == 0) {
+                    break;
+                }
+            }
+
+            body_start = line_index + 1 < source->lines_count ? source->line_starts[line_index + 1] : source->size;
+            body_end = end_line < source->lines_count ? source->line_starts[end_line] : source->size;
+
+            /* Copy the body with a single memcpy, null terminated (the terminator isn't part of the body length) */
+            current_mcro->data.body_length = body_end - body_start;
+            current_mcro->data.code_lines_count = end_line - (line_index + 1);
+            current_mcro->data.body = (char *) arena_alloc(table->arena, current_mcro->data.body_length + 1);
+            memcpy(current_mcro->data.body, source->data + body_start, current_mcro->data.body_length);
+            current_mcro->data.body[current_mcro->data.body_length] = '\0';
+
+            index_mcro_lines(table, &current_mcro->data, source, line_index + 1);
+
+            /* Add mcro to the macro table */
+            add_mcro(table, current_mcro);
+
+            line_index = end_line;
+        } else {
+            /* Check if the line is a macro call */
+            write_to_am_file(am, table, candidates, line, length);
+        }
+    }
+}
+
+/*
+ * Function: is_mcro_error
+ * -----------------------
+ * Checks if there is a macro call before its declaration.
+ * Only the candidates recorded while building the expanded source are checked, against the full macro table.
+ *
+ * am: The expanded source.
+ * table: The macro table.
+ * candidates: The recorded macro call candidates.
+ */
+void is_mcro_error(const struct am_source *am, const struct mcro_table *table,
+                   const struct mcro_candidates *candidates) {
+    const char *token;
+    int i, length;
+
+    for (i = 0; i < candidates->count; i++) {
+        length = get_first_token(am->text + am->line_starts[candidates->rows[i]],
+                                 am_source_line_length(am, candidates->rows[i]), &token);
+        if (get_mcro(table, token, length) != NULL) {
+            report_line_error(table->diagnostics, "am - ", candidates->rows[i],
+                              "ERROR MACRO CALLING BEFORE DECLARATION");
+        }
+    }
+}
+
+/*
+ * Function: am_builder
+ * --------------------
+ * Builds the expanded source (the content of the .am file) based on the given .as file.
+ *
+ * source: The .as file, loaded with its line index.
+ * am: The expanded source to build, should be empty.
+ * names: The pool the labels of the macro lines are interned in.
+ * diagnostics: Where the errors of the macros are reported.
+ */
+void am_builder(const struct source_file *source, struct am_source *am, struct intern_pool *names,
+                struct diagnostics *diagnostics) {
+    struct mcro_table table = {NULL, 0, 0, NULL, NULL, NULL};
+    struct mcro_candidates candidates = {NULL, 0, 0};
+
+    table.arena = &am->arena;
+    table.names = names;
+    table.diagnostics = diagnostics;
+    make_mcro_list_and_am_file(source, am, &table, &candidates);
+
+    is_mcro_error(am, &table, &candidates);
+
+    free(candidates.rows);
+}
+
+/*
+ * Function: write_am_file
+ * -----------------------
+ * Writes the expanded source to the .am file in a single write.
+ *
+ * am: The expanded source.
+ * file_name: The name of the .am file.
+ *
+ * returns: False if the file can't be opened.
+ */
+bool write_am_file(const struct am_source *am, const char *file_name) {
+    FILE *am_file = fopen(file_name, "w+");
+    if (am_file == NULL) {
+        return false;
+    }
+
+    fwrite(am->text, sizeof(char), am->text_length, am_file);
+    fclose(am_file);
+    return true;
+}
+
+/*
+ * Function: free_am_source
+ * ------------------------
+ * Frees the memory allocated for the expanded source, the macros are released at once with the arena.
+ *
+ * am: The expanded source.
+ */
+void free_am_source(struct am_source *am) {
+    free(am->text);
+    free(am->line_starts);
+    free(am->line_trees);
+    free_arena(&am->arena);
+    am->text = NULL;
+    am->line_starts = NULL;
+    am->line_trees = NULL;
+    am->text_length = am->text_capacity = 0;
+    am->lines_count = am->lines_capacity = 0;
+}
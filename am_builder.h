@@ -1,26 +1,89 @@
-#include "stdio.h"
-#include "utils.h"
-
-#ifndef ASSEMBLER_AM_BUILDER_H
-#define ASSEMBLER_AM_BUILDER_H
-
-struct file_struct{
-    FILE *file;
-    char name[MAX_LINE_SIZE];
-};
-
-struct mcro {
-    char mcro_name[MAX_LABEL_SIZE];
-    char* code_lines[MAX_LINE_SIZE];
-    int code_lines_count;
-};
-
-struct mcro_list {
-    struct mcro data;
-    struct mcro_list* next;
-};
-
-void am_builder(struct file_struct *as_file);
-
-
-#endif
+#include "stdio.h"
+#include "utils.h"
+#include "arena.h"
+#include "lexer.h"
+#include "source_reader.h"
+#include "diagnostics.h"
+
+#ifndef ASSEMBLER_AM_BUILDER_H
+#define ASSEMBLER_AM_BUILDER_H
+
+/*
+ * A line of a macro body: its offset in the body, if it looks like a macro call,
+ * and its syntax tree which is built once when the macro is declared (NULL if the line is too long).
+ */
+struct mcro_line {
+    int offset;
+    bool is_call_candidate;
+    struct syntax_tree *tree;
+};
+
+/*
+ * The body of a macro is stored as one contiguous buffer (in the arena of the macro table),
+ * the lines index tells where each line of the body starts.
+ */
+struct mcro {
+    char mcro_name[MAX_LABEL_SIZE];
+    char *body;
+    int body_length;
+    struct mcro_line *lines;
+    int code_lines_count;
+};
+
+struct mcro_list {
+    struct mcro data;
+    struct mcro_list* next;
+};
+
+/*
+ * Hash table of the macros, keyed on the macro name.
+ * Each bucket is a chain of the macros whose names hash to it.
+ * The table, the macros and their bodies are allocated from the arena.
+ * The labels of the macro lines are interned in names when the lines are lexed.
+ */
+struct mcro_table {
+    struct mcro_list **buckets;
+    int buckets_count;
+    int mcro_count;
+    struct arena *arena;
+    struct intern_pool *names;
+    struct diagnostics *diagnostics;
+};
+
+/*
+ * Rows of the expanded source that look like a call of a macro that wasn't declared (yet).
+ */
+struct mcro_candidates {
+    int *rows;
+    int count;
+    int capacity;
+};
+
+/*
+ * The expanded source (the content of the .am file) kept in memory.
+ * text holds all the lines one after the other, each one ends with '\n'.
+ * line_starts[i] is the offset of the i-th line inside text.
+ * line_trees[i] is the pre-built syntax tree of the i-th line when it comes from a macro, NULL otherwise.
+ * The macros and their syntax trees live in the arena, so they stay valid until the source is freed.
+ */
+struct am_source {
+    char *text;
+    int text_length;
+    int text_capacity;
+    int *line_starts;
+    const struct syntax_tree **line_trees;
+    int lines_count;
+    int lines_capacity;
+    struct arena arena;
+};
+
+#define EMPTY_AM_SOURCE {NULL, 0, 0, NULL, NULL, 0, 0, {NULL, NULL}}
+
+void am_builder(const struct source_file *source, struct am_source *am, struct intern_pool *names,
+                struct diagnostics *diagnostics);
+int am_source_line_length(const struct am_source *am, int index);
+bool write_am_file(const struct am_source *am, const char *file_name);
+void free_am_source(struct am_source *am);
+
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * This code implements a simple arena (bump) allocator.
+ * The memory is taken from a chain of blocks, and all of it is released at once by free_arena.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "arena.h"
+
+#define ALIGNMENT sizeof(void *)
+#define BLOCK_DATA(block) ((char *) ((block) + 1))
+
+/*
+ * Function: align
+ * ---------------
+ * Rounds a size up to the alignment of the arena.
+ */
+static int align(int size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+/*
+ * Function: new_block
+ * -------------------
+ * Moves the arena to a block with at least the given capacity.
+ * A free block that follows the current one (left from a reset) is reused when it is big enough.
+ *
+ * arena: The arena.
+ * capacity: The needed capacity.
+ */
+static void new_block(struct arena *arena, int capacity) {
+    struct arena_block *block = arena->current == NULL ? arena->head : arena->current->next;
+
+    if (block == NULL || block->capacity < capacity) {
+        if (capacity < ARENA_BLOCK_SIZE) {
+            capacity = ARENA_BLOCK_SIZE;
+        }
+
+        block = (struct arena_block *) malloc(sizeof(struct arena_block) + capacity);
+        if (block == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        block->capacity = capacity;
+
+        /* Link the new block right after the current one */
+        if (arena->current == NULL) {
+            block->next = arena->head;
+            arena->head = block;
+        } else {
+            block->next = arena->current->next;
+            arena->current->next = block;
+        }
+    }
+
+    block->used = 0;
+    arena->current = block;
+}
+
+/*
+ * Function: arena_alloc
+ * ---------------------
+ * Allocates memory from the arena.
+ *
+ * arena: The arena.
+ * size: The size of the allocation in bytes.
+ *
+ * returns: Pointer to the allocated memory.
+ */
+void *arena_alloc(struct arena *arena, int size) {
+    struct arena_block *block = arena->current;
+    char *object;
+
+    if (block == NULL || align(block->used) + size > block->capacity) {
+        new_block(arena, size);
+        block = arena->current;
+    }
+
+    block->used = align(block->used);
+    object = BLOCK_DATA(block) + block->used;
+    block->used += size;
+
+    return object;
+}
+
+/*
+ * Function: free_arena
+ * --------------------
+ * Frees all the memory of the arena.
+ *
+ * arena: The arena.
+ */
+void free_arena(struct arena *arena) {
+    struct arena_block *block = arena->head;
+
+    while (block != NULL) {
+        struct arena_block *temp = block;
+        block = block->next;
+        free(temp);
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
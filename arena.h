@@ -0,0 +1,27 @@
+#ifndef ASSEMBLER_ARENA_H
+#define ASSEMBLER_ARENA_H
+
+#define ARENA_BLOCK_SIZE 4096
+
+/*
+ * A block of memory of the arena, the data follows the header.
+ */
+struct arena_block {
+    struct arena_block *next;
+    int capacity;
+    int used;
+};
+
+/*
+ * Bump allocator: allocations are taken from the current block, and are all released together when the arena is freed.
+ * Pointers returned by the arena stay valid until then.
+ */
+struct arena {
+    struct arena_block *head;
+    struct arena_block *current;
+};
+
+void *arena_alloc(struct arena *arena, int size);
+void free_arena(struct arena *arena);
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Writes the binary object file (.bobj), see binary_object.h for its layout.
+ * The file is built in one buffer and written at once, the fields are stored little-endian whatever the host is.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binary_object.h"
+
+#define ALIGN(offset) (((offset) + OBJECT_ALIGNMENT - 1) / OBJECT_ALIGNMENT * OBJECT_ALIGNMENT)
+
+/*
+ * Function: put_u32
+ * -----------------
+ * Stores a 32-bit field, little-endian, and moves the cursor after it.
+ *
+ * cursor: The place of the field.
+ * value: The value of the field.
+ */
+static void put_u32(unsigned char **cursor, unsigned long value) {
+    (*cursor)[0] = (unsigned char) (value & 0xFF);
+    (*cursor)[1] = (unsigned char) ((value >> 8) & 0xFF);
+    (*cursor)[2] = (unsigned char) ((value >> 16) & 0xFF);
+    (*cursor)[3] = (unsigned char) ((value >> 24) & 0xFF);
+    *cursor += 4;
+}
+
+/*
+ * Function: put_words
+ * -------------------
+ * Stores the words of a coded list, little-endian. The buffer is zeroed, so the runs of 0 words are skipped.
+ *
+ * dest: The place of the first word.
+ * list: The coded list.
+ */
+static void put_words(unsigned char *dest, const struct coded_list *list) {
+    struct word_cursor words;
+    unsigned int word;
+    int count;
+
+    init_word_cursor(&words, list);
+    while ((count = next_words(&words, &word)) > 0) {
+        for (; count > 0; --count, dest += 2) {
+            if (word != 0) {
+                dest[0] = (unsigned char) (word & 0xFF);
+                dest[1] = (unsigned char) (word >> 8);
+            }
+        }
+    }
+}
+
+/*
+ * Function: put_section
+ * ---------------------
+ * Stores an entry of the section table.
+ */
+static void put_section(unsigned char **cursor, enum object_section_kind kind, unsigned long address,
+                        unsigned long words_offset, int words_count) {
+    put_u32(cursor, kind);
+    put_u32(cursor, address);
+    put_u32(cursor, words_offset);
+    put_u32(cursor, words_count);
+}
+
+/*
+ * Function: write_binary_object
+ * -----------------------------
+ * Writes the binary object file: the code and data sections, the symbols and the relocations of the words
+ * that hold the address of a symbol. The symbols are resolved and the words are patched already.
+ *
+ * symbols: The symbol table.
+ * inst_coded_list: The coded instructions (the code section), with their fixups.
+ * dir_coded_list: The coded directives (the data section).
+ * outputs: The outputs of the source.
+ */
+void write_binary_object(const struct symbol_table *symbols, const struct coded_list *inst_coded_list,
+                         const struct coded_list *dir_coded_list, struct output_files *outputs) {
+    unsigned long sections_offset, code_offset, data_offset, symbols_offset, relocations_offset, names_offset;
+    unsigned long names_size = 0, file_size, name_offset = 0;
+    const struct symbol *symbol;
+    const struct fixup *fixup;
+    const char *name;
+    unsigned char *buffer, *cursor;
+    FILE *file;
+    int i;
+
+    for (i = 0; i < symbols->symbols_count; ++i) {
+        names_size += strlen(get_interned_name(symbols->names, i)) + 1;
+    }
+
+    sections_offset = ALIGN(sizeof(struct object_header));
+    code_offset = ALIGN(sections_offset + 2 * sizeof(struct object_section));
+    data_offset = ALIGN(code_offset + 2 * inst_coded_list->length);
+    symbols_offset = ALIGN(data_offset + 2 * dir_coded_list->length);
+    relocations_offset = ALIGN(symbols_offset + symbols->symbols_count * sizeof(struct object_symbol));
+    names_offset = ALIGN(relocations_offset + inst_coded_list->fixups_count * sizeof(struct object_relocation));
+    file_size = names_offset + names_size;
+
+    buffer = (unsigned char *) calloc(file_size, 1);
+    if (buffer == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    cursor = buffer;
+    memcpy(cursor, OBJECT_MAGIC, 8);
+    cursor += 8;
+    put_u32(&cursor, OBJECT_VERSION);
+    put_u32(&cursor, sizeof(struct object_header));
+    put_u32(&cursor, file_size);
+    put_u32(&cursor, BASE_ADDRESS);
+    put_u32(&cursor, sections_offset);
+    put_u32(&cursor, 2);
+    put_u32(&cursor, symbols_offset);
+    put_u32(&cursor, symbols->symbols_count);
+    put_u32(&cursor, relocations_offset);
+    put_u32(&cursor, inst_coded_list->fixups_count);
+    put_u32(&cursor, names_offset);
+    put_u32(&cursor, names_size);
+
+    /*
+     * The directives come after the instructions
+     */
+    cursor = buffer + sections_offset;
+    put_section(&cursor, section_code, BASE_ADDRESS, code_offset, inst_coded_list->length);
+    put_section(&cursor, section_data, BASE_ADDRESS + inst_coded_list->length, data_offset, dir_coded_list->length);
+    put_words(buffer + code_offset, inst_coded_list);
+    put_words(buffer + data_offset, dir_coded_list);
+
+    cursor = buffer + symbols_offset;
+    for (i = 0; i < symbols->symbols_count; ++i) {
+        symbol = &symbols->symbols[i];
+        name = get_interned_name(symbols->names, i);
+
+        put_u32(&cursor, name_offset);
+        put_u32(&cursor, symbol->is_declared ? symbol->labels_index : 0);
+        put_u32(&cursor, symbol->is_declared ? (symbol->is_data ? section_data : section_code) : OBJECT_NO_SECTION);
+        put_u32(&cursor, (symbol->is_declared ? OBJECT_SYMBOL_DECLARED : 0) |
+                         (symbol->is_entry ? OBJECT_SYMBOL_ENTRY : 0) | (symbol->is_extern ? OBJECT_SYMBOL_EXTERN : 0));
+
+        memcpy(buffer + names_offset + name_offset, name, strlen(name) + 1);
+        name_offset += strlen(name) + 1;
+    }
+
+    cursor = buffer + relocations_offset;
+    for (i = 0; i < inst_coded_list->fixups_count; ++i) {
+        fixup = &inst_coded_list->fixups[i];
+
+        put_u32(&cursor, BASE_ADDRESS + fixup->offset);
+        put_u32(&cursor, fixup->symbol_id);
+        put_u32(&cursor, fixup->kind);
+    }
+
+    file = open_output(outputs, ".bobj");
+    if (file != NULL) {
+        fwrite(buffer, 1, file_size, file);
+        close_output(outputs, file);
+    }
+
+    free(buffer);
+}
@@ -0,0 +1,82 @@
+#ifndef ASSEMBLER_BINARY_OBJECT_H
+#define ASSEMBLER_BINARY_OBJECT_H
+
+#include <stdint.h>
+#include "coded_list.h"
+#include "symbol_table.h"
+#include "output_files.h"
+
+/*
+ * The binary object file (.bobj) keeps the whole result of the assembly in one file that can be mapped
+ * and used as is: every field is a little-endian uint32_t (the words are uint16_t), and every table starts
+ * at an offset that is a multiple of OBJECT_ALIGNMENT.
+ *
+ * The file is: the header, the section table, the words of each section, the symbol table, the relocation table,
+ * and the names of the symbols (null terminated).
+ */
+#define OBJECT_MAGIC "ASM12OBJ"
+#define OBJECT_VERSION 1
+#define OBJECT_ALIGNMENT 8
+
+struct object_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t file_size;
+    uint32_t base_address;
+    uint32_t sections_offset;
+    uint32_t sections_count;
+    uint32_t symbols_offset;
+    uint32_t symbols_count;
+    uint32_t relocations_offset;
+    uint32_t relocations_count;
+    uint32_t names_offset;
+    uint32_t names_size;
+};
+
+enum object_section_kind {
+    section_code = 0,
+    section_data = 1
+};
+
+/*
+ * A section: its kind, the address of its first word, and where its words are in the file.
+ */
+struct object_section {
+    uint32_t kind;
+    uint32_t address;
+    uint32_t words_offset;
+    uint32_t words_count;
+};
+
+#define OBJECT_SYMBOL_DECLARED 1
+#define OBJECT_SYMBOL_ENTRY 2
+#define OBJECT_SYMBOL_EXTERN 4
+#define OBJECT_NO_SECTION 0xFFFFFFFFUL
+
+/*
+ * A symbol, the index of a symbol is the id of its name. name_offset is from the start of the names,
+ * section is the index of the section of a declared symbol (OBJECT_NO_SECTION otherwise),
+ * and flags are OBJECT_SYMBOL_* bits (a symbol without flags is a name that isn't used as a symbol).
+ */
+struct object_symbol {
+    uint32_t name_offset;
+    uint32_t address;
+    uint32_t section;
+    uint32_t flags;
+};
+
+/*
+ * A word that holds the address of a symbol: its address, the index of the symbol, and its A R E kind
+ * (relocatable or external).
+ */
+struct object_relocation {
+    uint32_t address;
+    uint32_t symbol;
+    uint32_t kind;
+};
+
+void write_binary_object(const struct symbol_table *symbols, const struct coded_list *inst_coded_list,
+                         const struct coded_list *dir_coded_list, struct output_files *outputs);
+
+#endif
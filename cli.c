@@ -0,0 +1,498 @@
+/*
+ * Runs the assembler as its command line does: the options are parsed, and every file is assembled,
+ * one after the other or in parallel (-j). The messages are printed to a given stream, so the command line
+ * can be run for the program itself or for a client of the server.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "string.h"
+#include "cli.h"
+#include "lexer.h"
+#include "am_builder.h"
+#include "symbol_table.h"
+#include "coded_list.h"
+#include "first_pass.h"
+#include "second_pass.h"
+#include "source_reader.h"
+#include "thread_pool.h"
+
+/*
+ * The longest ending of an output file, with its terminator
+ */
+#define MAX_ENDING_SIZE 8
+
+/*
+ * The name of the file that is the standard input
+ */
+#define STDIN_FILE_NAME "-"
+
+/*
+ * The options of the command line that apply to every file, threads_count is the amount of workers
+ * the lines of a file can be coded on. The relative names of the files are in directory (NULL for the current one).
+ * The outputs of the standard input are written to obj_fd, ent_fd and ext_fd (-1 for the standard output).
+ * client_source is the standard input of a client of the server (NULL for the standard input of the process).
+ */
+struct assembler_options {
+    const char *directory;
+    const struct client_source *client_source;
+    bool keep_am;
+    bool one_pass;
+    bool lex_ahead;
+    int formats;
+    int threads_count;
+    int obj_fd;
+    int ent_fd;
+    int ext_fd;
+};
+
+/*
+ * What became of a file: it was assembled, its source has errors (or wasn't found), or it was assembled
+ * but some of its files couldn't be written.
+ */
+enum file_result {
+    file_assembled,
+    file_has_errors,
+    file_not_written
+};
+
+/*
+ * Function: make_path
+ * -------------------
+ * Makes the path of a file, in the directory of the options if its name is relative.
+ *
+ * path: Where to write the path, MAX_PATH_SIZE characters (with room for the ending of an output file).
+ * directory: The directory, NULL for the current one.
+ * file_name: The name of the file.
+ * ending: Added to the name.
+ *
+ * returns: False if the path is too long.
+ */
+static bool make_path(char *path, const char *directory, const char *file_name, const char *ending){
+    size_t directory_length = directory != NULL && file_name[0] != '/' ? strlen(directory) + 1 : 0;
+
+    if(directory_length + strlen(file_name) + strlen(ending) >= MAX_PATH_SIZE - MAX_ENDING_SIZE){
+        return false;
+    }
+
+    path[0] = '\0';
+    if(directory_length > 0){
+        strcat(strcpy(path, directory), "/");
+    }
+    strcat(strcat(path, file_name), ending);
+    return true;
+}
+
+/*
+ * Function: assembler
+ * -------------------
+ * Assembles a single file, the messages about the file are printed to output.
+ * The file "-" is the standard input: its outputs are written to the standard output as sections
+ * (or to the file descriptors of the options), and no file is written for it. The standard input of a client
+ * of the server is the source it sent, and its outputs are written to the stream of the client.
+ *
+ * file_name: The name of the file, without the .as ending.
+ * options: The options of the command line.
+ * output: The stream the messages are printed to.
+ *
+ * returns: What became of the file, a file that can't be written is reported to output.
+ */
+static enum file_result assembler(const char *file_name, const struct assembler_options *options, FILE *output){
+    char input_name[MAX_PATH_SIZE], path[MAX_PATH_SIZE];
+    bool is_stdin = strcmp(file_name, STDIN_FILE_NAME) == 0, is_open;
+    enum file_result result = file_assembled;
+    struct output_files outputs;
+    struct source_file source;
+    struct am_source am = EMPTY_AM_SOURCE;
+    struct intern_pool names;
+    struct diagnostics diagnostics;
+
+    struct symbol_table symbols;
+    struct coded_list inst_coded_list;
+    struct coded_list dir_coded_list;
+
+    int *errors_counter = (int *)malloc(sizeof (int)), i;
+
+    *errors_counter = 0;
+
+    if(is_stdin && options->client_source != NULL){
+        open_source_buffer(&source, options->client_source->data, options->client_source->size);
+        is_open = true;
+    } else if(is_stdin){
+        is_open = open_source_fd(&source, STDIN_FILENO);
+    } else {
+        is_open = make_path(path, options->directory, file_name, ".as") && open_source_file(&source, path);
+    }
+
+    if(!is_open){
+        make_path(input_name, NULL, file_name, is_stdin ? "" : ".as");
+        fprintf(output, "***************\n");
+        fprintf(output, "File %s Doesn't Found\n", input_name);
+        fprintf(output, "***************\n");
+
+        free(errors_counter);
+
+        return file_has_errors;
+    }
+
+    /*
+     * The labels of all the lines are interned in one pool, the symbol table is indexed by their ids
+     */
+    init_diagnostics(&diagnostics, output, false);
+    init_intern_pool(&names);
+    am_builder(&source, &am, &names, &diagnostics);
+    close_source_file(&source);
+
+    /*
+     * The expanded source stays in memory, the .am file is written only if it was requested
+     */
+    if(options->keep_am && !is_stdin){
+        path[strlen(path) - 1] = 'm';
+        if(!write_am_file(&am, path)){
+            fprintf(output, "There Was Problem With Open The File %s\n", path);
+            result = file_not_written;
+        }
+    }
+
+
+    init_symbol_table(&symbols, &names, &diagnostics);
+    init_coded_list(&inst_coded_list);
+    init_coded_list(&dir_coded_list);
+
+    fprintf(output, "%s\n", file_name);
+    for (i = 0; i < strlen(file_name); ++i) {
+        fprintf(output, "-");
+    }
+    fprintf(output, "\n");
+
+
+    first_pass(&am, &names, &symbols, &inst_coded_list, &dir_coded_list, errors_counter, options->one_pass,
+               options->threads_count, options->lex_ahead, &diagnostics);
+
+    if(*errors_counter != 0){
+        fprintf(output, "There Are %d Errors\n", *errors_counter);
+        result = file_has_errors;
+    } else {
+        if(is_stdin){
+            init_output_stream(&outputs, file_name, output,
+                               options->client_source != NULL ? options->client_source->outputs : stdout,
+                               options->obj_fd, options->ent_fd, options->ext_fd);
+        } else {
+            make_path(path, options->directory, file_name, "");
+            init_output_files(&outputs, path, output);
+        }
+        if(second_pass(&symbols, &inst_coded_list, &dir_coded_list, &outputs, options->formats)){
+            fprintf(output, "Files Created Successfully :)\n");
+        } else {
+            fprintf(output, "Not All The Files Were Created\n");
+            result = file_not_written;
+        }
+    }
+
+    for (i = 0; i < strlen(file_name); ++i) {
+        fprintf(output, "*");
+    }
+    fprintf(output, "\n");
+
+    free(errors_counter);
+    free_coded_list(&inst_coded_list);
+    free_coded_list(&dir_coded_list);
+    free_symbol_table(&symbols);
+    free_intern_pool(&names);
+    free_am_source(&am);
+    free_diagnostics(&diagnostics);
+
+    return result;
+}
+
+/*
+ * The files of a parallel run. Each file is assembled by a worker, and its messages are kept in its own
+ * temporary stream until they are printed in the order of the command line (NULL if it couldn't be opened).
+ * results tells what became of every file.
+ */
+struct assembler_jobs {
+    char **files;
+    const struct assembler_options *options;
+    FILE **outputs;
+    enum file_result *results;
+};
+
+/*
+ * A file and the size of its source, to start the largest files first.
+ */
+struct job_size {
+    int job;
+    long size;
+};
+
+static void assemble_job(void *context, int job){
+    struct assembler_jobs *jobs = (struct assembler_jobs *) context;
+    FILE *output = tmpfile();
+
+    jobs->outputs[job] = output;
+    jobs->results[job] = output != NULL ? assembler(jobs->files[job], jobs->options, output) : file_not_written;
+}
+
+static int compare_job_sizes(const void *first, const void *second){
+    long first_size = ((const struct job_size *) first)->size, second_size = ((const struct job_size *) second)->size;
+
+    if(first_size != second_size){
+        return first_size < second_size ? 1 : -1;
+    }
+    return ((const struct job_size *) first)->job - ((const struct job_size *) second)->job;
+}
+
+/*
+ * Function: print_job_output
+ * --------------------------
+ * Prints the messages of a file that was assembled by a worker, and closes its temporary stream.
+ *
+ * job_output: The temporary stream of the file, NULL if it couldn't be opened (then the file wasn't assembled).
+ * output: The stream the messages are printed to.
+ */
+static void print_job_output(FILE *job_output, FILE *output){
+    char buffer[4096];
+    size_t length;
+
+    if(job_output == NULL){
+        fprintf(output, "There Was Problem With Open A Temporary File\n");
+        return;
+    }
+
+    rewind(job_output);
+    while ((length = fread(buffer, 1, sizeof(buffer), job_output)) > 0) {
+        fwrite(buffer, 1, length, output);
+    }
+    fclose(job_output);
+}
+
+/*
+ * Function: assemble_files_in_parallel
+ * ------------------------------------
+ * Assembles the files on a pool of threads_count workers, the largest files are started first.
+ * Every file is coded on its worker alone, the workers are busy with the other files.
+ * The messages are printed in the order of the files, as soon as every file before them is done,
+ * so the output is the same as when the files are assembled one after the other.
+ *
+ * files: The names of the files.
+ * files_count: The amount of files.
+ * options: The options of the command line.
+ * threads_count: The amount of workers.
+ * output: The stream the messages are printed to.
+ * results: Set to what became of every file.
+ */
+static void assemble_files_in_parallel(char **files, int files_count, const struct assembler_options *options,
+                                       int threads_count, FILE *output, enum file_result *results){
+    char input_name[MAX_PATH_SIZE];
+    struct assembler_options job_options = *options;
+    struct assembler_jobs jobs;
+    struct job_size *sizes = (struct job_size *) malloc(files_count * sizeof(struct job_size));
+    int *order = (int *) malloc(files_count * sizeof(int));
+    struct thread_pool *pool;
+    int i;
+
+    jobs.files = files;
+    job_options.threads_count = 1;
+    jobs.options = &job_options;
+    jobs.outputs = (FILE **) malloc(files_count * sizeof(FILE *));
+    jobs.results = results;
+    if(sizes == NULL || order == NULL || jobs.outputs == NULL){
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < files_count; ++i) {
+        sizes[i].job = i;
+        sizes[i].size = make_path(input_name, options->directory, files[i], ".as") ? source_file_size(input_name) : -1;
+    }
+    qsort(sizes, files_count, sizeof(struct job_size), compare_job_sizes);
+    for (i = 0; i < files_count; ++i) {
+        order[i] = sizes[i].job;
+    }
+
+    pool = start_thread_pool(threads_count < files_count ? threads_count : files_count, order, files_count,
+                             assemble_job, &jobs);
+    for (i = 0; i < files_count; ++i) {
+        wait_for_task(pool, i);
+        print_job_output(jobs.outputs[i], output);
+    }
+    join_thread_pool(pool);
+
+    free(jobs.outputs);
+    free(order);
+    free(sizes);
+}
+
+/*
+ * Function: parse_fd_option
+ * -------------------------
+ * Parses the file descriptor of an --obj-fd, --ent-fd or --ext-fd option.
+ *
+ * text: The text after the '='.
+ *
+ * returns: The file descriptor, -1 if the text isn't a non negative number.
+ */
+static int parse_fd_option(const char *text){
+    if(text[0] == '\0' || strspn(text, "0123456789") != strlen(text)){
+        return -1;
+    }
+    return atoi(text);
+}
+
+/*
+ * Function: parse_jobs_option
+ * ---------------------------
+ * Parses the amount of workers of a -j option.
+ *
+ * text: The text of the amount.
+ *
+ * returns: The amount of workers, -1 if the text isn't a positive number (or has anything after it).
+ */
+static int parse_jobs_option(const char *text){
+    char *end;
+    long value = strtol(text, &end, 10);
+
+    if(end == text || *end != '\0' || value < 1 || value > INT_MAX){
+        return -1;
+    }
+    return (int) value;
+}
+
+/*
+ * Function: run_command_line
+ * --------------------------
+ * Assembles the files given in the arguments of the command line, with the options given in them.
+ * When the standard input is assembled (the file "-"), its outputs are on the standard output,
+ * so the messages are printed to the standard error instead of output.
+ *
+ * count: The amount of arguments.
+ * arguments: The arguments, without the name of the program.
+ * directory: The directory the relative file names are in, NULL for the current one
+ *            (a client of the server, which can pass its standard input only as a client source).
+ * client_source: The standard input of a client of the server, NULL for the standard input of the process.
+ *                The messages about it stay on output.
+ * output: The stream the messages are printed to.
+ *
+ * returns: The exit status of the command line, 1 if an option is wrong, a file couldn't be written
+ *          or the standard input has errors.
+ */
+int run_command_line(int count, char **arguments, const char *directory, const struct client_source *client_source,
+                     FILE *output) {
+    struct assembler_options options;
+    char **files = (char **) malloc((count + 1) * sizeof(char *));
+    enum file_result *results = (enum file_result *) malloc((count + 1) * sizeof(enum file_result));
+    const char *fd_option = NULL;
+    bool has_stdin = false;
+    int *fd, i, files_count = 0, status = 0;
+
+    options.directory = directory;
+    options.client_source = client_source;
+    options.keep_am = false;
+    options.one_pass = false;
+    options.lex_ahead = false;
+    options.formats = DEFAULT_FORMATS;
+    options.threads_count = 1;
+    options.obj_fd = options.ent_fd = options.ext_fd = -1;
+    if(files == NULL || results == NULL){
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < count; ++i) {
+        has_stdin = has_stdin || strcmp(arguments[i], STDIN_FILE_NAME) == 0;
+        if(strcmp(arguments[i], STDIN_FILE_NAME) == 0 && client_source == NULL){
+            if(directory != NULL){
+                fprintf(output, "The Server Can't Assemble The Standard Input\n");
+                status = 1;
+            }
+            output = stderr;
+        }
+    }
+
+    for (i = 0; i < count && status == 0; ++i) {
+        if(strcmp(arguments[i], "--keep-am") == 0){
+            options.keep_am = true;
+        } else if(strcmp(arguments[i], "--one-pass") == 0){
+            options.one_pass = true;
+        } else if(strcmp(arguments[i], "--lex-ahead") == 0){
+            options.lex_ahead = true;
+        } else if(strncmp(arguments[i], "--format=", 9) == 0){
+            options.formats = parse_object_formats(arguments[i] + 9);
+            if(options.formats == -1){
+                fprintf(output, "Unknown Format In %s (The Formats Are base64, base16, bin, ihex, srec, rle, object)\n", arguments[i]);
+                status = 1;
+            }
+        } else if(strncmp(arguments[i], "--obj-fd=", 9) == 0 || strncmp(arguments[i], "--ent-fd=", 9) == 0 ||
+                  strncmp(arguments[i], "--ext-fd=", 9) == 0){
+            fd = arguments[i][2] == 'o' ? &options.obj_fd : arguments[i][3] == 'n' ? &options.ent_fd : &options.ext_fd;
+            *fd = parse_fd_option(arguments[i] + 9);
+            fd_option = arguments[i];
+            if(directory != NULL){
+                /*
+                 * The file descriptors would be the server's, not the client's
+                 */
+                fprintf(output, "The Server Can't Write To The File Descriptor In %s\n", arguments[i]);
+                status = 1;
+            } else if(*fd == -1){
+                fprintf(output, "The File Descriptor In %s Should Be A Non Negative Number\n", arguments[i]);
+                status = 1;
+            } else if(fcntl(*fd, F_GETFD) == -1){
+                /*
+                 * A file descriptor that isn't open is found now, before any source is assembled
+                 */
+                fprintf(output, "The File Descriptor In %s Isn't Open\n", arguments[i]);
+                status = 1;
+            }
+        } else if(strncmp(arguments[i], "-j", 2) == 0){
+            /*
+             * The amount of workers comes right after -j, or as the next argument
+             */
+            options.threads_count = parse_jobs_option(arguments[i][2] != '\0' ? arguments[i] + 2 :
+                                                      (i + 1 < count ? arguments[++i] : ""));
+            if(options.threads_count == -1){
+                fprintf(output, "The Amount Of Jobs After -j Should Be A Positive Number\n");
+                status = 1;
+            }
+        } else if(strncmp(arguments[i], "--", 2) == 0){
+            fprintf(output, "Unknown Option %s\n", arguments[i]);
+            status = 1;
+        } else {
+            files[files_count++] = arguments[i];
+        }
+    }
+
+    if(status == 0 && fd_option != NULL && !has_stdin){
+        fprintf(output, "The Option %s Is Only For The Standard Input (\"-\")\n", fd_option);
+        status = 1;
+    }
+
+    if(status != 0){
+        free(results);
+        free(files);
+        return status;
+    }
+
+    if(options.threads_count > 1 && files_count > 1){
+        assemble_files_in_parallel(files, files_count, &options, options.threads_count, output, results);
+    } else {
+        for (i = 0; i < files_count; ++i) {
+            results[i] = assembler(files[i], &options, output);
+        }
+    }
+
+    for (i = 0; i < files_count; ++i) {
+        if(results[i] == file_not_written ||
+           (results[i] == file_has_errors && strcmp(files[i], STDIN_FILE_NAME) == 0)){
+            status = 1;
+        }
+    }
+
+    free(results);
+    free(files);
+    return status;
+}
@@ -0,0 +1,19 @@
+#ifndef ASSEMBLER_CLI_H
+#define ASSEMBLER_CLI_H
+
+#include <stdio.h>
+
+/*
+ * The standard input of a command line that runs for a client of the server: the source the client read
+ * from its standard input (size bytes of data), and the stream its outputs are written to as sections.
+ */
+struct client_source {
+    const char *data;
+    long size;
+    FILE *outputs;
+};
+
+int run_command_line(int count, char **arguments, const char *directory, const struct client_source *source,
+                     FILE *output);
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * The thin client of the assembler server: it has the command line of the assembler, and sends it
+ * (with the current directory) to the server, which assembles the files and writes the output files.
+ * The messages of the server are printed, and its exit status is the exit status of the client.
+ * The socket of the server is ASSEMBLER_SOCKET, or the default socket (see get_default_socket_path),
+ * and only a server of the same user is trusted.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "socket_io.h"
+
+/*
+ * Function: connect_to_server
+ * ---------------------------
+ * Connects to the socket of the server.
+ *
+ * returns: The connection, -1 if the server can't be reached.
+ */
+static int connect_to_server(const char *socket_path) {
+    struct sockaddr_un address;
+    int fd;
+
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*
+ * Function: receive_to
+ * --------------------
+ * Receives a part of the response (its length and its bytes) and writes it to a stream.
+ *
+ * returns: False if the connection was lost.
+ */
+static bool receive_to(int fd, FILE *stream) {
+    char buffer[4096];
+    unsigned long length, part;
+
+    if (!receive_number(fd, &length)) {
+        return false;
+    }
+
+    for (; length > 0; length -= part) {
+        part = length < sizeof(buffer) ? length : sizeof(buffer);
+        if (!receive_all(fd, buffer, part)) {
+            return false;
+        }
+        fwrite(buffer, 1, part, stream);
+    }
+
+    return true;
+}
+
+/*
+ * Function: read_standard_input
+ * -----------------------------
+ * Reads the standard input to a temporary stream, so it can be sent with its length.
+ *
+ * returns: The stream, NULL if it can't be made or the input is over the limit of a source.
+ */
+static FILE *read_standard_input(void) {
+    FILE *source = tmpfile();
+    char buffer[4096];
+    size_t length;
+
+    if (source == NULL) {
+        return NULL;
+    }
+
+    while ((length = fread(buffer, 1, sizeof(buffer), stdin)) > 0) {
+        fwrite(buffer, 1, length, source);
+    }
+
+    if (ftell(source) > MAX_REQUEST_SOURCE_SIZE) {
+        fclose(source);
+        return NULL;
+    }
+    return source;
+}
+
+int main(int argc, char **argv) {
+    char socket_path[MAX_PATH_SIZE], directory[MAX_PATH_SIZE];
+    enum request_kind kind = request_files;
+    unsigned long status;
+    FILE *source = NULL;
+    bool is_answered;
+    int fd, i = 1;
+
+    if (getenv("ASSEMBLER_SOCKET") != NULL && strlen(getenv("ASSEMBLER_SOCKET")) < sizeof(socket_path)) {
+        strcpy(socket_path, getenv("ASSEMBLER_SOCKET"));
+    } else {
+        get_default_socket_path(socket_path);
+    }
+
+    if (getcwd(directory, sizeof(directory)) == NULL) {
+        printf("There Was Problem With Get The Current Directory\n");
+        return 1;
+    }
+
+    /*
+     * The standard input ("-") is sent with the request, the server sends its outputs back
+     */
+    for (; i < argc; ++i) {
+        if (strcmp(argv[i], "-") == 0) {
+            kind = request_source;
+        }
+    }
+    if (kind == request_source && (source = read_standard_input()) == NULL) {
+        fprintf(stderr, "The Standard Input Can't Be Sent To The Assembler Server\n");
+        return 1;
+    }
+
+    fd = connect_to_server(socket_path);
+    if (fd < 0) {
+        printf("Can't Connect To The Assembler Server On %s\n", socket_path);
+        return 1;
+    }
+
+    if (!is_same_user(fd)) {
+        printf("The Assembler Server On %s Belongs To Another User\n", socket_path);
+        close(fd);
+        return 1;
+    }
+
+    /*
+     * As in the command line, the messages about the standard input go to the standard error
+     */
+    is_answered = send_request(fd, kind, directory, argc - 1, argv + 1) &&
+                  (source == NULL || send_stream(fd, source)) && receive_number(fd, &status) &&
+                  receive_to(fd, source == NULL ? stdout : stderr) && (source == NULL || receive_to(fd, stdout));
+
+    if (source != NULL) {
+        fclose(source);
+    }
+    close(fd);
+
+    if (!is_answered) {
+        printf("The Connection To The Assembler Server Was Lost\n");
+        return 1;
+    }
+    return (int) status;
+}
@@ -1,371 +1,526 @@
-/*
- * This code is a collection of functions that manipulate a linked list of coded lines.
- * The list is represented by the struct coded_list, which contains a head pointer to the first node in the list
- * and a length variable that keeps track of the number of nodes in the list.
- */
-
-#include "coded_list.h"
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-
-enum operand_type {
-    immediate = 1,
-    direct = 3,
-    direct_register = 5
-};
-
-/*
- * Function: add_str_to_list
- * -------------------------
- * Adds a new coded line to the end of the coded list.
- *
- * list: The coded list to add the line to.
- * code: The coded line to be added.
- */
-static void add_str_to_list(struct coded_list *list, const char *code) {
-    struct coded_node *next = (struct coded_node *) malloc(sizeof(struct coded_node));
-    struct coded_node *current;
-
-    strcpy(next->coded_line, code);
-    next->next = NULL;
-
-    current = list->head;
-    if (current == NULL) {
-        list->head = next;
-        list->length++;
-    } else {
-        while (current->next != NULL) {
-            current = current->next;
-        }
-        current->next = next;
-        list->length++;
-    }
-}
-
-/*
- * Function: get_register_number
- * -----------------------------
- * Returns the register number extracted from the register string.
- *
- * reg: The register string (e.g., "r1", "r2", etc.).
- *
- * returns: The register number.
- */
-static int get_register_number(const char *reg) {
-    int i = reg[2] - '0';
-    return i;
-}
-
-/*
- * Function: parse_inst_op_code
- * ----------------------------
- * Parses the instruction's op code and determines the source and destination operand types.
- * It generates the binary code for the op code and operand types.
- *
- * dest: The destination string to store the generated binary code.
- * st: The syntax tree containing the instruction information.
- * source_type: Pointer to the variable to store the source operand type.
- * des_type: Pointer to the variable to store the destination operand type.
- */
-void parse_inst_op_code(char *dest,const struct syntax_tree st, int *source_type, int *des_type) {
-    char binary_code[14] = "";
-
-    /* Code the source operand type - 9-11 bits */
-    if (st.dir_or_inst.inst.opCode == op_code_mov ||
-        st.dir_or_inst.inst.opCode == op_code_cmp ||
-        st.dir_or_inst.inst.opCode == op_code_add ||
-        st.dir_or_inst.inst.opCode == op_code_sub ||
-        st.dir_or_inst.inst.opCode == op_code_lea) {
-        if (is_valid_number(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter)) {
-            *source_type = immediate;
-            strcat(binary_code, "001");
-        } else if (is_valid_var(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter)) {
-            *source_type = direct;
-            strcat(binary_code, "011");
-        } else if (is_valid_register(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter)) {
-            *source_type = direct_register;
-            strcat(binary_code, "101");
-        }
-    } else {
-        *source_type = 0;
-        strcat(binary_code, "000");
-    }
-
-    /* Code the op code - 8-5 bits */
-    strcat(binary_code, decimal_to_binary(st.dir_or_inst.inst.opCode - 1, 4));
-
-    /* Code the destination operand type - 4-2 bits */
-    if (st.dir_or_inst.inst.opCode == op_code_stop ||
-        st.dir_or_inst.inst.opCode == op_code_rts) {
-        *des_type = 0;
-        strcat(binary_code, "000");
-    } else {
-        if (is_valid_number(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter)) {
-            *des_type = immediate;
-            strcat(binary_code, "001");
-        } else if (is_valid_var(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter)) {
-            *des_type = direct;
-            strcat(binary_code, "011");
-        } else if (is_valid_register(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter)) {
-            *des_type = direct_register;
-            strcat(binary_code, "101");
-        }
-    }
-    /* A R E */
-    strcat(binary_code, "00");
-
-    strcpy(dest, binary_code);
-}
-
-/*
- * Function: parse_inst_des_parameter
- * ----------------------------------
- * Parses the instruction's destination parameter and generates the binary code for it.
- *
- * dest: The destination string to store the generated binary code.
- * st: The syntax tree containing the instruction information.
- * des_type: The destination operand type.
- * symbol_list: The list of symbols encountered in the code.
- * coded_list: The list of coded lines.
- */
-void parse_inst_des_parameter(char *dest, struct syntax_tree st, int des_type, struct symbol_list *symbol_list,
-                              struct coded_list coded_list) {
-    char binary_code[14] = "";
-    struct symbol_list *next;
-
-    if (des_type == immediate) {
-        int source = atoi(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter);
-        strcat(binary_code, decimal_to_binary(source, 10));
-        strcat(binary_code, "00");
-    } else if (des_type == direct_register) {
-        strcat(binary_code, "00000");
-        strcat(binary_code, decimal_to_binary(
-                get_register_number(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter),
-                5));
-        strcat(binary_code, "00");
-    } else if (des_type == direct) {
-        strcpy(binary_code, st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter);
-
-        next = (struct symbol_list *) malloc(sizeof(struct symbol_list));
-        next->symbol = (struct symbol *) malloc(sizeof (struct symbol));
-
-        next->next = NULL;
-        strcpy(next->symbol->label, st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter);
-        next->symbol->outsource_type = non;
-        next->symbol->appearance_type = usage;
-        next->symbol->labels_index = coded_list.length;
-
-         add_to_symbol_list(symbol_list, next);
-    }
-
-    strcpy(dest, binary_code);
-}
-
-/*
- * Function: parse_inst_src_parameter
- * ----------------------------------
- * Parses the instruction's source parameter and generates the binary code for it.
- *
- * dest: The destination string to store the generated binary code.
- * st: The syntax tree containing the instruction information.
- * source_type: The source operand type.
- * symbol_list: The list of symbols encountered in the code.
- * coded_list: The list of coded lines.
- */
-void parse_inst_src_parameter(char *dest, struct syntax_tree st, int source_type, struct symbol_list *symbol_list,
-                              struct coded_list coded_list) {
-    char binary_code[14] = "";
-    struct symbol_list *next;
-
-    if (source_type == immediate) {
-        int source = atoi(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter);
-        strcpy(binary_code, decimal_to_binary(source, 10));
-        strcat(binary_code, "00");
-    } else if (source_type == direct_register) {
-        strcat(binary_code, decimal_to_binary(
-                get_register_number(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter),
-                5));
-        strcat(binary_code, "00000");
-        strcat(binary_code, "00");
-    } else if (source_type == direct) {
-        strcpy(binary_code, st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter);
-
-        next = (struct symbol_list *) malloc(sizeof(struct symbol_list));
-        next->symbol = (struct symbol *) malloc(sizeof (struct symbol));
-
-        next->next = NULL;
-        strcpy(next->symbol->label, st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter);
-        next->symbol->outsource_type = non;
-        next->symbol->appearance_type = usage;
-        next->symbol->labels_index = coded_list.length;
-
-         add_to_symbol_list(symbol_list, next);
-    }
-
-    strcpy(dest, binary_code);
-}
-
-/*
- * Function: parse_instruction_to_code
- * -----------------------------------
- * Parses an instruction syntax tree node and generates the binary code for it.
- * It calls the respective functions to parse the op code, source parameter, and destination parameter.
- * The generated binary code is then added to the coded list.
- *
- * coded_list: The coded list to add the binary code to.
- * st: The syntax tree containing the instruction information.
- * symbol_list: The list of symbols encountered in the code.
- */
-void parse_instruction_to_code(struct coded_list *coded_list, struct syntax_tree st, struct symbol_list *symbol_list) {
-    char binary_code[14] = "";
-    int source_type, des_type;
-
-    parse_inst_op_code(binary_code, st, &source_type, &des_type);
-
-    add_str_to_list(coded_list, binary_code);
-    strcpy(binary_code, "");
-
-    if (source_type == direct_register && des_type == direct_register) {
-        strcat(binary_code, decimal_to_binary(
-                get_register_number(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter), 5));
-        strcat(binary_code, decimal_to_binary(
-                get_register_number(st.dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter), 5));
-        /* A R E */
-        strcat(binary_code, "00");
-
-        add_str_to_list(coded_list, binary_code);
-    } else {
-        if(get_num_of_parameters_inst(st.dir_or_inst.inst.opCode) == 2){
-            parse_inst_src_parameter(binary_code, st, source_type, symbol_list, *coded_list);
-            add_str_to_list(coded_list, binary_code);
-        }
-
-        if(get_num_of_parameters_inst(st.dir_or_inst.inst.opCode) > 0){
-            parse_inst_des_parameter(binary_code, st, des_type, symbol_list, *coded_list);
-            add_str_to_list(coded_list, binary_code);
-
-            strcpy(binary_code, "");
-        }
-    }
-}
-
-/*
- * Function: parse_directive_to_code
- * ---------------------------------
- * Parses a directive syntax tree node and generates the binary code for it.
- * The generated binary code is then added to the coded list.
- *
- * list: The coded list to add the binary code to.
- * st: The syntax tree containing the directive information.
- * symbol_list: The list of symbols encountered in the code.
- * extern_symbols: The list of external symbols encountered in the code.
- */
-int parse_directive_to_code(struct coded_list *list, struct syntax_tree st, struct symbol_list *symbol_list, struct symbol_list *extern_symbols) {
-    char binary_code[14] = "";
-    int i, error_counter = 0;
-    struct symbol_list *next = (struct symbol_list *) malloc(sizeof(struct symbol_list));
-    next->symbol = (struct  symbol*) malloc(sizeof (struct symbol));
-
-    switch (st.dir_or_inst.dir.dirType) {
-        case string:
-            for (i = 0; i < strlen(st.dir_or_inst.dir.dir_info.str); ++i) {
-                strcpy(binary_code, "");
-                strcpy(binary_code, decimal_to_binary((int) st.dir_or_inst.dir.dir_info.str[i], 12));
-                add_str_to_list(list, binary_code);
-            }
-            strcpy(binary_code, "000000000000");
-            add_str_to_list(list, binary_code);
-            break;
-
-        case data:
-            for (i = 0; i < st.dir_or_inst.dir.dir_info.num_arr.arr_length; ++i) {
-                strcpy(binary_code, "");
-                strcpy(binary_code, decimal_to_binary(st.dir_or_inst.dir.dir_info.num_arr.int_arr[i], 12));
-                add_str_to_list(list, binary_code);
-            }
-            break;
-
-        case entry:
-            next->next = NULL;
-            strcpy(next->symbol->label, st.dir_or_inst.dir.dir_info.label);
-            next->symbol->outsource_type = ent;
-            next->symbol->labels_index = -2;
-
-            error_counter += add_to_symbol_list(symbol_list, next);
-            break;
-
-        case external:
-            next->next = NULL;
-            strcpy(next->symbol->label, st.dir_or_inst.dir.dir_info.label);
-            next->symbol->outsource_type = ext;
-            next->symbol->appearance_type = non;
-
-            error_counter += add_to_external_symbol_list(extern_symbols, next);
-            break;
-        case non:
-            break;
-    }
-
-    return error_counter;
-}
-
-/*
- * Function: parse_syntax_tree_to_code
- * -----------------------------------
- * Parses a syntax tree node and generates the binary code for it.
- * It checks whether the node represents an instruction or a directive and calls the respective parsing function.
- *
- * coded_list: The coded list to add the binary code to.
- * st: The syntax tree node to be parsed.
- * symbol_list: The list of symbols encountered in the code.
- * extern_symbols: The list of external symbols encountered in the code.
- */
-int parse_syntax_tree_to_code(struct coded_list *coded_list, struct syntax_tree st, struct symbol_list *symbol_list,
-                               struct symbol_list *extern_symbols) {
-    int error_counter = 0;
-
-    if(strlen(st.label) != 0){
-        struct symbol_list *next = (struct symbol_list *) malloc(sizeof(struct symbol_list));
-        next->symbol = (struct symbol *) malloc(sizeof (struct symbol));
-
-        next->next = NULL;
-        strcpy(next->symbol->label, st.label);
-        next->symbol->outsource_type = non;
-        next->symbol->appearance_type = declaration;
-        next->symbol->labels_index = coded_list->length;
-
-        error_counter += add_to_symbol_list(symbol_list, next);
-    }
-
-    if (st.lineType == directive) {
-        error_counter += parse_directive_to_code(coded_list, st, symbol_list, extern_symbols);
-    } else if (st.lineType == instruction) {
-        parse_instruction_to_code(coded_list, st, symbol_list);
-    }
-
-    return error_counter;
-}
-
-/*
- * Function: add_code_to_coded_list
- * --------------------------------
- * Adds the binary code generated from a syntax tree node to the coded list.
- * It calls the respective parsing function based on whether the node represents an instruction or a directive.
- *
- * list: The coded list to add the binary code to.
- * st: The syntax tree node containing the code to be added.
- * symbols: The list of symbols encountered in the code.
- * extern_symbols: The list of external symbols encountered in the code.
- */
-int add_code_to_coded_list(struct coded_list *list, struct syntax_tree st, struct symbol_list *symbols,
-                            struct symbol_list *extern_symbols) {
-    int error_counter = 0;
-
-    error_counter += parse_syntax_tree_to_code(list, st, symbols, extern_symbols);
-
-    if (error_counter > 0) {
-        printf("%d\n", error_counter);
-    }
-    return error_counter;
-}
+/*
+ * This code is a collection of functions that code the lines of the source into a coded list.
+ * The list is represented by the struct coded_list, which keeps the 12-bit words in one growable array,
+ * with the amount of words in length, and the fixups of the words that hold the address of a label.
+ */
+
+#include "coded_list.h"
+#include "isa.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+/*
+ * The fields of the words: the first word of an instruction holds the source addressing method (bits 9-11),
+ * the op code (bits 5-8) and the destination addressing method (bits 2-4). A register operand is in bits 7-11
+ * as a source and in bits 2-6 as a destination.
+ */
+#define SRC_TYPE_SHIFT 9
+#define OP_CODE_SHIFT 5
+#define DES_TYPE_SHIFT 2
+#define SRC_REGISTER_SHIFT 7
+#define DES_REGISTER_SHIFT 2
+
+#define FIRST_WORD(op, src, des) \
+        ((uint16_t) (((src) << SRC_TYPE_SHIFT) | ((op) << OP_CODE_SHIFT) | ((des) << DES_TYPE_SHIFT)))
+#define DES_TYPES(op, src) {FIRST_WORD(op, src, 0), FIRST_WORD(op, src, 1), FIRST_WORD(op, src, 2), \
+        FIRST_WORD(op, src, 3), FIRST_WORD(op, src, 4), FIRST_WORD(op, src, 5), FIRST_WORD(op, src, 6), \
+        FIRST_WORD(op, src, 7)}
+#define SRC_TYPES(op) {DES_TYPES(op, 0), DES_TYPES(op, 1), DES_TYPES(op, 2), DES_TYPES(op, 3), \
+        DES_TYPES(op, 4), DES_TYPES(op, 5), DES_TYPES(op, 6), DES_TYPES(op, 7)}
+
+/*
+ * The first word of every instruction, indexed by the op code bits, the source and the destination addressing methods
+ * (0 when there is no operand). It is built at compile time, the A R E bits of a first word are always 00.
+ */
+static const uint16_t first_words[16][8][8] = {
+        SRC_TYPES(0), SRC_TYPES(1), SRC_TYPES(2), SRC_TYPES(3),
+        SRC_TYPES(4), SRC_TYPES(5), SRC_TYPES(6), SRC_TYPES(7),
+        SRC_TYPES(8), SRC_TYPES(9), SRC_TYPES(10), SRC_TYPES(11),
+        SRC_TYPES(12), SRC_TYPES(13), SRC_TYPES(14), SRC_TYPES(15)
+};
+
+/*
+ * Function: add_word_to_list
+ * --------------------------
+ * Adds a new word to the end of the coded list.
+ *
+ * list: The coded list to add the word to.
+ * word: The word to be added, only its lowest 12 bits are kept.
+ */
+static void add_word_to_list(struct coded_list *list, unsigned int word) {
+    if (list->words_count == list->capacity) {
+        uint16_t *grown;
+
+        list->capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+        grown = (uint16_t *) realloc(list->words, list->capacity * sizeof(uint16_t));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        list->words = grown;
+    }
+
+    list->words[list->words_count++] = (uint16_t) (word & WORD_MASK);
+    list->length++;
+}
+
+/*
+ * Function: add_run_to_list
+ * -------------------------
+ * Adds a run of the same word to the end of the coded list, without storing the words.
+ * Every run is kept on its own, even when it continues the last run of the list: add_line_size counts a run
+ * for every line, and a part of the list never touches the runs of the parts before it.
+ *
+ * list: The coded list to add the run to.
+ * word: The word of the run.
+ * count: The amount of words in the run.
+ */
+static void add_run_to_list(struct coded_list *list, unsigned int word, int count) {
+    struct word_run *run;
+
+    if (list->runs_count == list->runs_capacity) {
+        struct word_run *grown;
+
+        list->runs_capacity = list->runs_capacity == 0 ? 8 : list->runs_capacity * 2;
+        grown = (struct word_run *) realloc(list->runs, list->runs_capacity * sizeof(struct word_run));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        list->runs = grown;
+    }
+
+    run = &list->runs[list->runs_count++];
+    run->offset = list->length;
+    run->count = count;
+    run->word = (uint16_t) (word & WORD_MASK);
+    list->length += count;
+}
+
+/*
+ * Function: init_word_cursor
+ * --------------------------
+ * Starts a walk over the words of a coded list.
+ *
+ * cursor: The cursor.
+ * list: The coded list.
+ */
+void init_word_cursor(struct word_cursor *cursor, const struct coded_list *list) {
+    cursor->list = list;
+    cursor->offset = 0;
+    cursor->word_index = 0;
+    cursor->run_index = 0;
+}
+
+/*
+ * Function: next_words
+ * --------------------
+ * Gives the next words of the walk: a stored word, or a whole run.
+ *
+ * cursor: The cursor.
+ * word: Pointer to the variable to store the word.
+ *
+ * returns: The amount of times the word repeats (1 for a stored word), 0 at the end of the list.
+ */
+int next_words(struct word_cursor *cursor, unsigned int *word) {
+    const struct coded_list *list = cursor->list;
+    const struct word_run *run;
+
+    if (cursor->offset >= list->length) {
+        return 0;
+    }
+
+    if (cursor->run_index < list->runs_count && list->runs[cursor->run_index].offset == cursor->offset) {
+        run = &list->runs[cursor->run_index++];
+        *word = run->word;
+        cursor->offset += run->count;
+        return run->count;
+    }
+
+    *word = list->words[cursor->word_index++];
+    cursor->offset++;
+    return 1;
+}
+
+/*
+ * Function: add_fixup
+ * -------------------
+ * Records that the next word of the coded list holds the address of a label.
+ *
+ * list: The coded list.
+ * symbol_id: The id of the label.
+ */
+static void add_fixup(struct coded_list *list, int symbol_id) {
+    struct fixup *fixup;
+
+    if (list->fixups_count == list->fixups_capacity) {
+        struct fixup *grown;
+
+        list->fixups_capacity = list->fixups_capacity == 0 ? 16 : list->fixups_capacity * 2;
+        grown = (struct fixup *) realloc(list->fixups, list->fixups_capacity * sizeof(struct fixup));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        list->fixups = grown;
+    }
+
+    fixup = &list->fixups[list->fixups_count++];
+    fixup->offset = list->length;
+    fixup->symbol_id = symbol_id;
+    fixup->kind = are_relocatable;
+    fixup->previous_use = -1;
+    fixup->is_patched = false;
+}
+
+/*
+ * Function: patch_fixup
+ * ---------------------
+ * Codes the word of a fixup: the address (0 for an external label) and the A R E kind of the fixup.
+ *
+ * list: The coded list of the fixup.
+ * fixup: The fixup, its word is already in the coded list.
+ * address: The address of the label.
+ */
+void patch_fixup(struct coded_list *list, struct fixup *fixup, int address) {
+    unsigned int word = fixup->kind == are_external ? 0 : (unsigned int) address << ARE_BITS;
+
+    list->words[fixup->offset] = (uint16_t) ((word | fixup->kind) & WORD_MASK);
+    fixup->is_patched = true;
+}
+
+/*
+ * Function: init_coded_list
+ * -------------------------
+ * Initializes an empty coded list.
+ *
+ * list: The coded list.
+ */
+void init_coded_list(struct coded_list *list) {
+    list->words = NULL;
+    list->words_count = 0;
+    list->length = 0;
+    list->capacity = 0;
+    list->runs = NULL;
+    list->runs_count = 0;
+    list->runs_capacity = 0;
+    list->fixups = NULL;
+    list->fixups_count = 0;
+    list->fixups_capacity = 0;
+}
+
+/*
+ * Function: free_coded_list
+ * -------------------------
+ * Frees the words and the fixups of a coded list.
+ *
+ * list: The coded list.
+ */
+void free_coded_list(struct coded_list *list) {
+    free(list->words);
+    free(list->runs);
+    free(list->fixups);
+    init_coded_list(list);
+}
+
+/*
+ * Function: parse_inst_op_code
+ * ----------------------------
+ * Parses the instruction's op code and determines the source and destination operand types.
+ * The first word of the instruction is taken from the table of the first words.
+ *
+ * st: The syntax tree containing the instruction information.
+ * source_type: Pointer to the variable to store the source operand type.
+ * des_type: Pointer to the variable to store the destination operand type.
+ *
+ * returns: The first word of the instruction.
+ */
+unsigned int parse_inst_op_code(const struct syntax_tree *st, int *source_type, int *des_type) {
+    const struct instruction_info *info = get_instruction_info(st->dir_or_inst.inst.opCode);
+
+    /* The addressing method values are their codes */
+    *source_type = info->operands_count == 2 ? st->dir_or_inst.inst.src.type : 0;
+    *des_type = info->operands_count > 0 ? st->dir_or_inst.inst.des.type : 0;
+
+    return first_words[info->op_code_bits][*source_type][*des_type];
+}
+
+/*
+ * Function: parse_inst_des_parameter
+ * ----------------------------------
+ * Parses the instruction's destination parameter and generates its word.
+ *
+ * st: The syntax tree containing the instruction information.
+ * des_type: The destination operand type.
+ * coded_list: The list of coded lines, a direct operand adds a fixup for its word.
+ *
+ * returns: The word of the parameter (0 for a direct operand, which is patched later).
+ */
+unsigned int parse_inst_des_parameter(const struct syntax_tree *st, int des_type, struct coded_list *coded_list) {
+    const struct operand *operand = &st->dir_or_inst.inst.des;
+
+    if (des_type == immediate) {
+        return (unsigned int) operand->data.value << ARE_BITS;
+    } else if (des_type == direct_register) {
+        return (unsigned int) operand->data.value << DES_REGISTER_SHIFT;
+    } else if (des_type == direct) {
+        add_fixup(coded_list, operand->data.symbol_id);
+    }
+
+    return 0;
+}
+
+/*
+ * Function: parse_inst_src_parameter
+ * ----------------------------------
+ * Parses the instruction's source parameter and generates its word.
+ *
+ * st: The syntax tree containing the instruction information.
+ * source_type: The source operand type.
+ * coded_list: The list of coded lines, a direct operand adds a fixup for its word.
+ *
+ * returns: The word of the parameter (0 for a direct operand, which is patched later).
+ */
+unsigned int parse_inst_src_parameter(const struct syntax_tree *st, int source_type, struct coded_list *coded_list) {
+    const struct operand *operand = &st->dir_or_inst.inst.src;
+
+    if (source_type == immediate) {
+        return (unsigned int) operand->data.value << ARE_BITS;
+    } else if (source_type == direct_register) {
+        return (unsigned int) operand->data.value << SRC_REGISTER_SHIFT;
+    } else if (source_type == direct) {
+        add_fixup(coded_list, operand->data.symbol_id);
+    }
+
+    return 0;
+}
+
+/*
+ * Function: parse_instruction_to_code
+ * -----------------------------------
+ * Parses an instruction syntax tree node and generates its words.
+ * It calls the respective functions to parse the op code, source parameter, and destination parameter.
+ * The generated words are then added to the coded list.
+ *
+ * coded_list: The coded list to add the words to.
+ * st: The syntax tree containing the instruction information.
+ */
+void parse_instruction_to_code(struct coded_list *coded_list, const struct syntax_tree *st) {
+    int source_type, des_type;
+
+    add_word_to_list(coded_list, parse_inst_op_code(st, &source_type, &des_type));
+
+    if (source_type == direct_register && des_type == direct_register) {
+        /* Both registers share one word */
+        add_word_to_list(coded_list,
+                         ((unsigned int) st->dir_or_inst.inst.src.data.value << SRC_REGISTER_SHIFT) |
+                         ((unsigned int) st->dir_or_inst.inst.des.data.value << DES_REGISTER_SHIFT));
+    } else {
+        if(source_type != 0){
+            add_word_to_list(coded_list, parse_inst_src_parameter(st, source_type, coded_list));
+        }
+
+        if(des_type != 0){
+            add_word_to_list(coded_list, parse_inst_des_parameter(st, des_type, coded_list));
+        }
+    }
+}
+
+/*
+ * Function: parse_directive_to_code
+ * ---------------------------------
+ * Parses a directive syntax tree node and generates its words.
+ * The generated words are then added to the coded list.
+ *
+ * list: The coded list to add the words to.
+ * st: The syntax tree containing the directive information.
+ */
+void parse_directive_to_code(struct coded_list *list, const struct syntax_tree *st) {
+    int i;
+
+    switch (st->dir_or_inst.dir.dirType) {
+        case string:
+            for (i = 0; i < st->dir_or_inst.dir.dir_info.str.length; ++i) {
+                add_word_to_list(list, (unsigned int) st->dir_or_inst.dir.dir_info.str.start[i]);
+            }
+            add_word_to_list(list, 0);
+            break;
+
+        case data:
+            for (i = 0; i < st->dir_or_inst.dir.dir_info.num_arr.arr_length; ++i) {
+                add_word_to_list(list, (unsigned int) st->dir_or_inst.dir.dir_info.num_arr.int_arr[i]);
+            }
+            break;
+
+        case space:
+            add_run_to_list(list, 0, st->dir_or_inst.dir.dir_info.space_length);
+            break;
+
+        case entry:
+        case external:
+        case non:
+            break;
+    }
+}
+
+/*
+ * Function: code_line
+ * -------------------
+ * Adds the words of a line to the end of the coded list, with the fixups of its label operands.
+ * The symbol table isn't used, so lines can be coded in any order (see add_line_symbols).
+ *
+ * list: The coded list to add the words to.
+ * st: The syntax tree of the line.
+ */
+void code_line(struct coded_list *list, const struct syntax_tree *st) {
+    if (st->lineType == directive) {
+        parse_directive_to_code(list, st);
+    } else if (st->lineType == instruction) {
+        parse_instruction_to_code(list, st);
+    }
+}
+
+/*
+ * Function: add_line_symbols
+ * --------------------------
+ * Adds what a line tells about the labels to the symbol table: the declaration of its label,
+ * an entry or an external label, and the usages of its label operands.
+ *
+ * symbols: The symbol table.
+ * st: The syntax tree of the line.
+ * offset: The offset of the first word of the line in its coded list.
+ *
+ * returns: The number of errors found.
+ */
+int add_line_symbols(struct symbol_table *symbols, const struct syntax_tree *st, int offset) {
+    int error_counter = 0, source_type, des_type;
+
+    if(st->label_id != -1){
+        error_counter += add_symbol_declaration(symbols, st->label_id, offset, st->lineType == directive);
+    }
+
+    if (st->lineType == directive && st->dir_or_inst.dir.dirType == entry) {
+        error_counter += add_entry_symbol(symbols, st->dir_or_inst.dir.dir_info.label_id);
+    } else if (st->lineType == directive && st->dir_or_inst.dir.dirType == external) {
+        error_counter += add_external_symbol(symbols, st->dir_or_inst.dir.dir_info.label_id);
+    } else if (st->lineType == instruction) {
+        parse_inst_op_code(st, &source_type, &des_type);
+        if (source_type == direct) {
+            add_symbol_usage(symbols, st->dir_or_inst.inst.src.data.symbol_id);
+        }
+        if (des_type == direct) {
+            add_symbol_usage(symbols, st->dir_or_inst.inst.des.data.symbol_id);
+        }
+    }
+
+    return error_counter;
+}
+
+/*
+ * Function: add_line_size
+ * -----------------------
+ * Adds the room a line takes in its coded list to a size. The size of a line is known from its syntax tree.
+ *
+ * size: The size to add to.
+ * st: The syntax tree of the line.
+ */
+void add_line_size(struct coded_size *size, const struct syntax_tree *st) {
+    int source_type, des_type, words = 0;
+
+    if (st->lineType == instruction) {
+        parse_inst_op_code(st, &source_type, &des_type);
+
+        /* Two registers share one word */
+        if (source_type == direct_register && des_type == direct_register) {
+            words = 2;
+        } else {
+            words = 1 + (source_type != 0) + (des_type != 0);
+        }
+        size->fixups += (source_type == direct) + (des_type == direct);
+    } else if (st->lineType == directive && st->dir_or_inst.dir.dirType == string) {
+        words = st->dir_or_inst.dir.dir_info.str.length + 1;
+    } else if (st->lineType == directive && st->dir_or_inst.dir.dirType == data) {
+        words = st->dir_or_inst.dir.dir_info.num_arr.arr_length;
+    } else if (st->lineType == directive && st->dir_or_inst.dir.dirType == space) {
+        size->length += st->dir_or_inst.dir.dir_info.space_length;
+        size->runs++;
+    }
+
+    size->length += words;
+    size->words += words;
+}
+
+/*
+ * Function: reserve_coded_list
+ * ----------------------------
+ * Allocates the room of an empty coded list for a known size, so the lines can be coded at their places.
+ *
+ * list: The coded list, empty.
+ * size: The size of all the lines of the list.
+ */
+void reserve_coded_list(struct coded_list *list, const struct coded_size *size) {
+    list->capacity = size->words;
+    list->runs_capacity = size->runs;
+    list->fixups_capacity = size->fixups;
+    list->words = (uint16_t *) malloc((size->words + 1) * sizeof(uint16_t));
+    list->runs = (struct word_run *) malloc((size->runs + 1) * sizeof(struct word_run));
+    list->fixups = (struct fixup *) malloc((size->fixups + 1) * sizeof(struct fixup));
+    if (list->words == NULL || list->runs == NULL || list->fixups == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+}
+
+/*
+ * Function: init_coded_list_part
+ * ------------------------------
+ * Makes a part of a reserved coded list, which starts at a given size. The lines added to the part are coded
+ * at their places in the list, so the parts can be filled at the same time. The part never grows the list.
+ *
+ * part: The part to make.
+ * list: The reserved coded list.
+ * start: The size of the lines before the part.
+ */
+void init_coded_list_part(struct coded_list *part, const struct coded_list *list, const struct coded_size *start) {
+    *part = *list;
+    part->words_count = start->words;
+    part->length = start->length;
+    part->runs_count = start->runs;
+    part->fixups_count = start->fixups;
+}
+
+/*
+ * Function: set_coded_list_size
+ * -----------------------------
+ * Sets the size of a reserved coded list, after all of its parts were filled.
+ *
+ * list: The coded list.
+ * size: The size of all the lines of the list.
+ */
+void set_coded_list_size(struct coded_list *list, const struct coded_size *size) {
+    list->words_count = size->words;
+    list->length = size->length;
+    list->runs_count = size->runs;
+    list->fixups_count = size->fixups;
+}
+
+/*
+ * Function: add_code_to_coded_list
+ * --------------------------------
+ * Adds a line to the symbol table and its words to the end of the coded list.
+ *
+ * list: The coded list to add the binary code to.
+ * st: The syntax tree node containing the code to be added.
+ * symbols: The symbol table.
+ */
+int add_code_to_coded_list(struct coded_list *list, const struct syntax_tree *st, struct symbol_table *symbols) {
+    int error_counter = 0;
+
+    error_counter += add_line_symbols(symbols, st, list->length);
+    code_line(list, st);
+
+    if (error_counter > 0 && symbols->diagnostics->stream != NULL) {
+        fprintf(symbols->diagnostics->stream, "%d\n", error_counter);
+    }
+    return error_counter;
+}
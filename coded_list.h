@@ -1,22 +1,101 @@
-#ifndef ASSEMBLER_CODED_LIST_H
-#define ASSEMBLER_CODED_LIST_H
-
-#include "lexer.h"
-#include "utils.h"
-#include "string.h"
-#include "symbol_table.h"
-
- struct coded_node {
-    char coded_line[MAX_LABEL_SIZE];
-    struct coded_node *next;
-};
-
- struct coded_list {
-    struct coded_node *head;
-    int length;
-};
-
-int add_code_to_coded_list(struct coded_list *list, struct syntax_tree st, struct symbol_list *symbols,
-                            struct symbol_list *extern_symbols);
-
-#endif
+#ifndef ASSEMBLER_CODED_LIST_H
+#define ASSEMBLER_CODED_LIST_H
+
+#include <stdint.h>
+#include "lexer.h"
+#include "utils.h"
+#include "string.h"
+#include "symbol_table.h"
+
+/*
+ * A word of the machine is 12 bits, the lowest 2 bits of an operand word are its A R E bits.
+ */
+#define WORD_MASK 0xFFF
+#define ARE_BITS 2
+
+/*
+ * The A R E bits of a word.
+ */
+enum are_kind {
+    are_absolute = 0,
+    are_external = 1,
+    are_relocatable = 2
+};
+
+/*
+ * A word that holds the address of a label: its offset in the coded list, the id of the label,
+ * and its A R E kind, which is relocatable until the word is found to use an external label.
+ * In one-pass mode the fixups of a label that isn't declared yet are chained, previous_use is the index of
+ * the previous fixup of the same label (-1 at the end of the chain).
+ */
+struct fixup {
+    int offset;
+    int symbol_id;
+    enum are_kind kind;
+    int previous_use;
+    bool is_patched;
+};
+
+/*
+ * A run of the same word, reserved by .space: count words from offset (in the coded list) that are not stored.
+ */
+struct word_run {
+    int offset;
+    int count;
+    uint16_t word;
+};
+
+/*
+ * The coded words, kept in one growable array. A word that holds the address of a label is 0 until its fixup
+ * patches it. The fixups are a side table, recorded in the order of their words.
+ * length is the amount of words in the list, words_count is the amount of stored words: the runs are kept
+ * in their own table and take no room in the words. Only the directives have runs, so the offset of an
+ * instruction word is its index in the words.
+ */
+struct coded_list {
+    uint16_t *words;
+    int words_count;
+    int length;
+    int capacity;
+    struct word_run *runs;
+    int runs_count;
+    int runs_capacity;
+    struct fixup *fixups;
+    int fixups_count;
+    int fixups_capacity;
+};
+
+/*
+ * Walks over the words of a coded list in order, a run is given at once.
+ */
+struct word_cursor {
+    const struct coded_list *list;
+    int offset;
+    int word_index;
+    int run_index;
+};
+
+/*
+ * The room lines take in a coded list: the amount of words, of stored words, of runs and of fixups.
+ */
+struct coded_size {
+    int length;
+    int words;
+    int runs;
+    int fixups;
+};
+
+void init_coded_list(struct coded_list *list);
+void free_coded_list(struct coded_list *list);
+void patch_fixup(struct coded_list *list, struct fixup *fixup, int address);
+int add_code_to_coded_list(struct coded_list *list, const struct syntax_tree *st, struct symbol_table *symbols);
+void code_line(struct coded_list *list, const struct syntax_tree *st);
+int add_line_symbols(struct symbol_table *symbols, const struct syntax_tree *st, int offset);
+void add_line_size(struct coded_size *size, const struct syntax_tree *st);
+void reserve_coded_list(struct coded_list *list, const struct coded_size *size);
+void init_coded_list_part(struct coded_list *part, const struct coded_list *list, const struct coded_size *start);
+void set_coded_list_size(struct coded_list *list, const struct coded_size *size);
+void init_word_cursor(struct word_cursor *cursor, const struct coded_list *list);
+int next_words(struct word_cursor *cursor, unsigned int *word);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * The errors of an assembly, printed to a stream and/or kept as records, see diagnostics.h.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "diagnostics.h"
+
+/*
+ * Function: init_diagnostics
+ * --------------------------
+ * Initializes the diagnostics of a file, without records.
+ *
+ * diagnostics: The diagnostics.
+ * stream: The stream the errors are printed to, NULL to not print them.
+ * keep_records: If the errors are kept as records.
+ */
+void init_diagnostics(struct diagnostics *diagnostics, FILE *stream, bool keep_records) {
+    diagnostics->stream = stream;
+    diagnostics->keep_records = keep_records;
+    diagnostics->records = NULL;
+    diagnostics->records_count = 0;
+    diagnostics->records_capacity = 0;
+}
+
+/*
+ * Function: add_diagnostic
+ * ------------------------
+ * Formats the message of an error, prints it and keeps it.
+ *
+ * diagnostics: The diagnostics.
+ * prefix: Printed before the number of the line, NULL if the error isn't of a line (then the message is printed alone).
+ * line: The number of the line.
+ * format: The format of the message.
+ * arguments: The arguments of the format.
+ */
+static void add_diagnostic(struct diagnostics *diagnostics, const char *prefix, int line, const char *format,
+                           va_list arguments) {
+    char message[MAX_DIAGNOSTIC_SIZE];
+    struct diagnostic *record;
+
+    vsnprintf(message, MAX_DIAGNOSTIC_SIZE, format, arguments);
+
+    if (diagnostics->stream != NULL) {
+        if (prefix != NULL) {
+            fprintf(diagnostics->stream, "%s%d: %s\n", prefix, line, message);
+        } else {
+            fprintf(diagnostics->stream, "%s\n", message);
+        }
+    }
+
+    if (!diagnostics->keep_records) {
+        return;
+    }
+
+    if (diagnostics->records_count == diagnostics->records_capacity) {
+        struct diagnostic *grown;
+
+        diagnostics->records_capacity = diagnostics->records_capacity == 0 ? 16 : diagnostics->records_capacity * 2;
+        grown = (struct diagnostic *) realloc(diagnostics->records,
+                                              diagnostics->records_capacity * sizeof(struct diagnostic));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        diagnostics->records = grown;
+    }
+
+    record = &diagnostics->records[diagnostics->records_count++];
+    record->line = line;
+    strcpy(record->message, message);
+}
+
+/*
+ * Function: report_line_error
+ * ---------------------------
+ * Reports an error of a line, it is printed as the prefix, the number of the line and the message.
+ *
+ * diagnostics: The diagnostics.
+ * prefix: Printed before the number of the line ("" for none).
+ * line: The number of the line (from 1).
+ * format: The format of the message, followed by its arguments.
+ */
+void report_line_error(struct diagnostics *diagnostics, const char *prefix, int line, const char *format, ...) {
+    va_list arguments;
+
+    va_start(arguments, format);
+    add_diagnostic(diagnostics, prefix, line, format, arguments);
+    va_end(arguments);
+}
+
+/*
+ * Function: report_error
+ * ----------------------
+ * Reports an error that isn't of a single line, it is printed as the message alone.
+ *
+ * diagnostics: The diagnostics.
+ * format: The format of the message, followed by its arguments.
+ */
+void report_error(struct diagnostics *diagnostics, const char *format, ...) {
+    va_list arguments;
+
+    va_start(arguments, format);
+    add_diagnostic(diagnostics, NULL, 0, format, arguments);
+    va_end(arguments);
+}
+
+/*
+ * Function: free_diagnostics
+ * --------------------------
+ * Frees the records of the diagnostics, the stream isn't closed.
+ *
+ * diagnostics: The diagnostics.
+ */
+void free_diagnostics(struct diagnostics *diagnostics) {
+    free(diagnostics->records);
+    diagnostics->records = NULL;
+    diagnostics->records_count = 0;
+    diagnostics->records_capacity = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef ASSEMBLER_DIAGNOSTICS_H
+#define ASSEMBLER_DIAGNOSTICS_H
+
+#include <stdio.h>
+#include "utils.h"
+
+/*
+ * The longest message of an error, with its terminator (a message holds at most a line of the source and a label).
+ */
+#define MAX_DIAGNOSTIC_SIZE 256
+
+/*
+ * An error found in the source: the number of its line as the command line prints it (0 for an error that isn't
+ * of a single line, like the errors of the labels that are found when the whole source was read), and its message.
+ */
+struct diagnostic {
+    int line;
+    char message[MAX_DIAGNOSTIC_SIZE];
+};
+
+/*
+ * Where the errors of a file go: every error is printed to stream the way the command line shows it
+ * (unless stream is NULL), and is kept in records when keep_records is true.
+ */
+struct diagnostics {
+    FILE *stream;
+    bool keep_records;
+    struct diagnostic *records;
+    int records_count;
+    int records_capacity;
+};
+
+void init_diagnostics(struct diagnostics *diagnostics, FILE *stream, bool keep_records);
+void report_line_error(struct diagnostics *diagnostics, const char *prefix, int line, const char *format, ...);
+void report_error(struct diagnostics *diagnostics, const char *format, ...);
+void free_diagnostics(struct diagnostics *diagnostics);
+
+#endif
@@ -1,171 +1,650 @@
-#include <malloc.h>
-#include "first_pass.h"
-
-/*
- * The print_symbols function iterates over the symbol list and prints the index, label,
- * outsource type, and appearance type of each symbol. It serves debugging purposes,
- * enabling a clear and formatted visualization of the symbol list content.
- */
-void print_symbols(struct symbol_list *list){
-    int i = 0;
-
-    while (list != NULL && list->symbol != NULL){
-        printf("%d: %s - %d, %d\n",list->symbol->labels_index , list->symbol->label, list->symbol->outsource_type, list->symbol->appearance_type);
-        i++;
-
-        list = list->next;
-    }
-}
-
-/*
- * The print_codes function iterates over the coded list and prints the index and
- * binary code of each node. It is useful for debugging purposes, to visually
- * inspect the content of the coded list in a readable and formatted manner.
- */
-void print_codes(struct coded_list *list){
-    int i = 100;
-    struct coded_node *node = list->head;
-
-    while (node != NULL){
-        printf("%d: %s\n",i , node->coded_line);
-        i++;
-
-        node = node->next;
-    }
-}
-
-/*
- * The verify_symbols function checks if the labels used in the symbol_list are declared either in
- * the symbol_list itself or in the ext_symbol_list. If a label is used but not declared, the function
- * prints an error message and increments the error_counter. This function serves as a semantic
- * validation step, ensuring that every symbol referenced in the code has a corresponding declaration.
- *
- * @param: struct symbol_list symbol_list - The list of symbols to be verified.
- * @param: struct symbol_list ext_symbol_list - The list of external symbols to be cross-referenced.
- * @return: int error_counter - The number of errors found during the verification process.
- */
-int verify_symbols(struct symbol_list symbol_list, struct symbol_list ext_symbol_list){
-    struct symbol_list *first = &symbol_list;
-    int error_counter = 0;
-
-    while (first != NULL){
-        if(index_of_label(&symbol_list, first->symbol->label) == -1 &&
-                index_of_label(&ext_symbol_list, first->symbol->label) == -1){
-            error_counter++;
-            printf("ERROR LABEL: \"%s\" USED BUT NEVER DECLARED\n", first->symbol->label);
-        }
-
-        first = first->next;
-    }
-
-    return error_counter;
-}
-
-/*
- * The first_pass function performs the first pass analysis of the assembly file. This includes building
- * the syntax tree for each line, classifying the line type (instruction, directive, or error), and
- * adding the codes to the appropriate list (inst_coded_list or dir_coded_list). The function also
- * manages symbols, updates external symbols, and verifies symbols. The function increments the error_counter
- * for each error encountered during these processes.
- *
- * @param: FILE *am_file - The assembly file to be analyzed.
- * @param: struct symbol_list *symbols - The list of symbols.
- * @param: struct symbol_list *ext_symbols - The list of external symbols.
- * @param: struct coded_list *inst_coded_list - The list of instruction codes.
- * @param: struct coded_list *dir_coded_list - The list of directive codes.
- * @param: int *errors_counter - Pointer to the counter of the errors found during the first pass.
- */
-void first_pass(FILE *am_file, struct symbol_list *symbols, struct symbol_list *ext_symbols,
-        struct coded_list *inst_coded_list, struct coded_list *dir_coded_list,
-                int *errors_counter){
-    char line[MAX_LINE_SIZE+1];
-    struct syntax_tree *st = (struct syntax_tree *) malloc(sizeof (struct syntax_tree));
-    struct symbol_list *inst_symbols = (struct symbol_list *) malloc(sizeof (struct symbol_list)),
-            *dir_symbols= (struct symbol_list *) malloc(sizeof (struct symbol_list));
-    int i = 1;
-
-    inst_symbols->symbol = NULL;
-    inst_symbols->next = NULL;
-
-    dir_symbols->symbol = NULL;
-    dir_symbols->next = NULL;
-
-
-    /*
-     * This loop reads the assembly file line by line until it reaches the end.
-     */
-    while (fgets(line, sizeof(line), am_file) != NULL){
-        /*
-        * This code checks if a line from the file exceeds a defined length. If so, it increments 'errors_counter', prints
-        * an error message, discards the rest of the line, and proceeds to the next line.
-        */
-        if(line[strlen(line) - 1] != '\n' && strlen(line) == MAX_LINE_SIZE){
-            (*errors_counter)++;
-            printf("%d: ERROR INPUT LENGTH IS TOO LONG\n", i);
-            do{
-                fgets(line, sizeof(line), am_file);
-            } while (line[strlen(line) - 1] != '\n');
-
-            i++;
-            continue;
-        }
-
-        /*
-         * Build syntax tree from line
-         */
-        build_syntax_tree_from_line(st, line);
-
-        /*
-         * If lineType is error, print error message and increment error counter
-         */
-        if(st->lineType == error) {
-            printf("%d: %s - \"%s\"\n", i, st->error_message, line);
-            *errors_counter = *errors_counter + 1;
-        }
-        /*
-         * If lineType is instruction, add code to instruction list and update error counter if needed
-         */
-         else if(st->lineType == instruction){
-            *errors_counter = *errors_counter + add_code_to_coded_list(inst_coded_list, *st, inst_symbols, ext_symbols);
-        }
-         /*
-          * If lineType is directive, add code to directive list and update error counter if needed
-          */
-          else if(st->lineType == directive){
-            *errors_counter = *errors_counter + add_code_to_coded_list(dir_coded_list, *st, dir_symbols, ext_symbols);
-        }
-
-        i++;
-    }
-
-    *errors_counter = *errors_counter + marge_list(inst_symbols, dir_symbols, inst_coded_list->length);
-    *errors_counter = *errors_counter + marge_list(symbols, inst_symbols, 100);
-    *errors_counter = *errors_counter + update_as_external(symbols, ext_symbols);
-
-    *errors_counter = *errors_counter + verify_symbols(*symbols, *ext_symbols);
-
-    /*
-    * Check if the total length of the instruction and directive coded lists exceeds the maximum memory size.
-    * If it does, increment the errors counter and print an error message indicating memory overflow.
-    */
-    if(inst_coded_list->length + dir_coded_list->length > MAX_MEMORY_SIZE){
-        (*errors_counter)++;
-        printf("ERROR: Memory Overflow");
-    }
-
-/*
-    printf("---------\n");
-    print_symbols(symbols);
-    printf("---------\n");
-    print_symbols(ext_symbols);
-    printf("---------\n");
-
-    print_codes(inst_coded_list);
-*/
-
-
-    free(st);
-    free_symbol_list(&inst_symbols);
-    free_symbol_list(&dir_symbols);
-}
-
+#include <malloc.h>
+#include <stdlib.h>
+#include "first_pass.h"
+#include "thread_pool.h"
+#include "spsc_ring.h"
+
+/*
+ * A source is coded in parallel only if every chunk has at least MIN_CHUNK_LINES lines,
+ * with up to CHUNKS_PER_THREAD chunks for every worker (so a worker that is done early can steal a chunk).
+ */
+#define MIN_CHUNK_LINES 256
+#define CHUNKS_PER_THREAD 4
+
+/*
+ * When the lexer runs ahead of the encoder, the lines are passed in batches of LEX_AHEAD_BATCH_LINES lines,
+ * LEX_AHEAD_BATCHES batches (a power of 2) are in the rings at most.
+ */
+#define LEX_AHEAD_BATCH_LINES 256
+#define LEX_AHEAD_BATCHES 8
+
+/*
+ * The print_symbols function iterates over the symbol table and prints the index, label,
+ * entry and external flags, and the amount of usages of each symbol. It serves debugging purposes,
+ * enabling a clear and formatted visualization of the symbol table content.
+ */
+void print_symbols(const struct symbol_table *table){
+    int i = 0;
+
+    for (; i < table->symbols_count; i++){
+        printf("%d: %s - %d, %d, %d\n", table->symbols[i].labels_index, get_interned_name(table->names, i),
+               table->symbols[i].is_entry, table->symbols[i].is_extern, table->symbols[i].uses_count);
+    }
+}
+
+/*
+ * The print_codes function iterates over the coded list and prints the index and
+ * binary code of each word. It is useful for debugging purposes, to visually
+ * inspect the content of the coded list in a readable and formatted manner.
+ * The bits of a run of equal words are written once, to a buffer on the stack.
+ */
+void print_codes(struct coded_list *list){
+    struct word_cursor words;
+    unsigned int word;
+    char bits[13];
+    int i = 0, count, bit;
+
+    init_word_cursor(&words, list);
+    while ((count = next_words(&words, &word)) > 0){
+        for (bit = 0; bit < 12; bit++){
+            bits[bit] = (word >> (11 - bit)) & 1 ? '1' : '0';
+        }
+        bits[12] = '\0';
+
+        for (; count > 0; count--, i++){
+            printf("%d: %s\n", i + BASE_ADDRESS, bits);
+        }
+    }
+}
+
+/*
+ * The backpatch_line function does the work of one-pass mode for a line that was just coded.
+ * If the line declares a label, the words in the chain of the label are patched with its address.
+ * Every new word that uses a label is patched at once if the label is declared already,
+ * and is added to the chain of the label otherwise. The code starts at BASE_ADDRESS, the addresses of the data labels
+ * are still missing the length of the instructions, those words are relocated by relocate_data_fixups.
+ *
+ * @param: const struct syntax_tree *tree - The syntax tree of the line.
+ * @param: struct symbol_table *symbols - The symbol table.
+ * @param: struct coded_list *inst_coded_list - The list of instruction codes, with its fixups.
+ * @param: int first_fixup - The index of the first fixup of the line.
+ */
+static void backpatch_line(const struct syntax_tree *tree, struct symbol_table *symbols,
+                           struct coded_list *inst_coded_list, int first_fixup){
+    const struct symbol *symbol;
+    struct fixup *fixup;
+    int i;
+
+    if(tree->label_id != -1 && find_symbol(symbols, tree->label_id)->is_declared){
+        symbol = find_symbol(symbols, tree->label_id);
+        for (i = take_pending_uses(symbols, tree->label_id); i != -1; i = fixup->previous_use){
+            fixup = &inst_coded_list->fixups[i];
+            patch_fixup(inst_coded_list, fixup, symbol->labels_index + BASE_ADDRESS);
+        }
+    }
+
+    for (i = first_fixup; i < inst_coded_list->fixups_count; i++){
+        fixup = &inst_coded_list->fixups[i];
+        symbol = find_symbol(symbols, fixup->symbol_id);
+
+        if(symbol->is_declared && !symbol->is_extern){
+            patch_fixup(inst_coded_list, fixup, symbol->labels_index + BASE_ADDRESS);
+        } else {
+            fixup->previous_use = add_pending_use(symbols, fixup->symbol_id, i);
+        }
+    }
+}
+
+/*
+ * The relocate_data_fixups function patches again, in one-pass mode, the words that use a data label,
+ * once the symbols were resolved and their addresses include the length of the instructions.
+ *
+ * @param: const struct symbol_table *symbols - The resolved symbol table.
+ * @param: struct coded_list *inst_coded_list - The list of instruction codes, with its fixups.
+ */
+static void relocate_data_fixups(const struct symbol_table *symbols, struct coded_list *inst_coded_list){
+    const struct symbol *symbol;
+    struct fixup *fixup;
+    int i = 0;
+
+    for (; i < inst_coded_list->fixups_count; i++){
+        fixup = &inst_coded_list->fixups[i];
+        symbol = find_symbol(symbols, fixup->symbol_id);
+
+        if(fixup->is_patched && symbol->is_data){
+            patch_fixup(inst_coded_list, fixup, symbol->labels_index);
+        }
+    }
+}
+
+/*
+ * The is_line_too_long function checks if a line of the expanded source (without its new line) is longer
+ * than MAX_LINE_SIZE.
+ */
+static bool is_line_too_long(const struct am_source *am, int index){
+    int length = am_source_line_length(am, index);
+
+    return length - (am->text[am->line_starts[index] + length - 1] == '\n') >= MAX_LINE_SIZE;
+}
+
+/*
+ * The code_source_line function handles a line of the expanded source after it was lexed: its error is printed,
+ * or its words are added to its coded list and its labels to the symbol table. In one-pass mode the words
+ * of the line are backpatched as soon as it is coded.
+ *
+ * @param: int i - The number of the line (from 1).
+ * @param: const struct syntax_tree *tree - The syntax tree of the line, NULL if the line is too long.
+ */
+static void code_source_line(const struct am_source *am, int i, const struct syntax_tree *tree,
+                             struct symbol_table *symbols, struct coded_list *inst_coded_list,
+                             struct coded_list *dir_coded_list, int *errors_counter, bool one_pass,
+                             struct diagnostics *diagnostics){
+    char line[MAX_LINE_SIZE+1];
+    int first_fixup;
+
+    /*
+    * This code checks if a line exceeds a defined length. If so, it increments 'errors_counter', prints
+    * an error message, and proceeds to the next line.
+    */
+    if(tree == NULL){
+        (*errors_counter)++;
+        report_line_error(diagnostics, "", i, "ERROR INPUT LENGTH IS TOO LONG");
+    }
+    /*
+     * If lineType is error, print error message and increment error counter
+     */
+    else if(tree->lineType == error) {
+        get_printable_line(tree, am->text + am->line_starts[i - 1], am_source_line_length(am, i - 1), line);
+        report_line_error(diagnostics, "", i, "%s - \"%s\"", get_error_message(tree->error), line);
+        *errors_counter = *errors_counter + 1;
+    }
+    /*
+     * If lineType is instruction, add code to instruction list and update error counter if needed
+     */
+     else if(tree->lineType == instruction){
+        first_fixup = inst_coded_list->fixups_count;
+        *errors_counter = *errors_counter + add_code_to_coded_list(inst_coded_list, tree, symbols);
+        if(one_pass){
+            backpatch_line(tree, symbols, inst_coded_list, first_fixup);
+        }
+    }
+     /*
+      * If lineType is directive, add code to directive list and update error counter if needed
+      */
+      else if(tree->lineType == directive){
+        *errors_counter = *errors_counter + add_code_to_coded_list(dir_coded_list, tree, symbols);
+        if(one_pass){
+            backpatch_line(tree, symbols, inst_coded_list, inst_coded_list->fixups_count);
+        }
+    }
+}
+
+/*
+ * The code_lines function goes over the lines one after the other: every line is lexed (unless it comes
+ * from a macro) and coded.
+ */
+static void code_lines(const struct am_source *am, struct intern_pool *names, struct symbol_table *symbols,
+                       struct coded_list *inst_coded_list, struct coded_list *dir_coded_list,
+                       int *errors_counter, bool one_pass, struct diagnostics *diagnostics){
+    struct syntax_tree *st = (struct syntax_tree *) malloc(sizeof (struct syntax_tree));
+    const struct syntax_tree *tree;
+    int i = 1;
+
+    /*
+     * This loop goes over the lines of the expanded source until it reaches the end.
+     */
+    for (; i <= am->lines_count; i++){
+        tree = NULL;
+
+        /*
+         * Lines that come from a macro already have a syntax tree, which was built when the macro was declared.
+         * Other lines are lexed in place, straight from the expanded source.
+         */
+        if(!is_line_too_long(am, i - 1)){
+            tree = am->line_trees[i - 1];
+            if(tree == NULL){
+                build_syntax_tree_from_line(st, am->text + am->line_starts[i - 1], am_source_line_length(am, i - 1),
+                                            names);
+                tree = st;
+            }
+        }
+
+        code_source_line(am, i, tree, symbols, inst_coded_list, dir_coded_list, errors_counter, one_pass,
+                         diagnostics);
+    }
+
+    free(st);
+}
+
+/*
+ * A chunk of the lines of the expanded source, for the parallel first pass. The labels of the lines a worker
+ * lexes are interned in the pool of the chunk, ids maps the ids of that pool to the ids of the file.
+ * The sizes of the lines are summed per chunk, and the starts are the sizes of all the chunks before it.
+ */
+struct line_chunk {
+    int first_line;
+    int end_line;
+    struct intern_pool names;
+    int *ids;
+    struct coded_size inst_size;
+    struct coded_size dir_size;
+    struct coded_size inst_start;
+    struct coded_size dir_start;
+};
+
+/*
+ * The state the workers of the parallel first pass share. Every worker writes only to its own chunk,
+ * the syntax trees of the lines of its chunk, and the places of those lines in the coded lists.
+ * line_trees holds the syntax tree of every line, NULL for a line that is too long.
+ */
+struct parallel_pass {
+    const struct am_source *am;
+    struct syntax_tree *trees;
+    const struct syntax_tree **line_trees;
+    struct line_chunk *chunks;
+    struct coded_list *inst_coded_list;
+    struct coded_list *dir_coded_list;
+};
+
+/*
+ * The lex_chunk function is the first phase of a worker: the lines of the chunk are lexed,
+ * and the room their words take in each coded list is summed.
+ */
+static void lex_chunk(void *context, int index){
+    struct parallel_pass *pass = (struct parallel_pass *) context;
+    struct line_chunk *chunk = &pass->chunks[index];
+    const struct am_source *am = pass->am;
+    const struct syntax_tree *tree;
+    int i = chunk->first_line;
+
+    for (; i < chunk->end_line; i++){
+        if(is_line_too_long(am, i)){
+            pass->line_trees[i] = NULL;
+            continue;
+        }
+
+        tree = am->line_trees[i];
+        if(tree == NULL){
+            build_syntax_tree_from_line(&pass->trees[i], am->text + am->line_starts[i], am_source_line_length(am, i),
+                                        &chunk->names);
+            tree = &pass->trees[i];
+        }
+        pass->line_trees[i] = tree;
+
+        add_line_size(tree->lineType == instruction ? &chunk->inst_size : &chunk->dir_size, tree);
+    }
+}
+
+/*
+ * The map_label_ids function replaces the ids of the labels in a syntax tree that was lexed in the pool
+ * of a chunk by their ids in the pool of the file.
+ */
+static void map_label_ids(struct syntax_tree *st, const int *ids){
+    if(st->label_id != -1){
+        st->label_id = ids[st->label_id];
+    }
+
+    if(st->lineType == instruction){
+        if(st->dir_or_inst.inst.src.type == direct){
+            st->dir_or_inst.inst.src.data.symbol_id = ids[st->dir_or_inst.inst.src.data.symbol_id];
+        }
+        if(st->dir_or_inst.inst.des.type == direct){
+            st->dir_or_inst.inst.des.data.symbol_id = ids[st->dir_or_inst.inst.des.data.symbol_id];
+        }
+    } else if(st->lineType == directive &&
+              (st->dir_or_inst.dir.dirType == entry || st->dir_or_inst.dir.dirType == external)){
+        st->dir_or_inst.dir.dir_info.label_id = ids[st->dir_or_inst.dir.dir_info.label_id];
+    }
+}
+
+/*
+ * The code_chunk function is the second phase of a worker: the words of the lines of the chunk are coded
+ * straight to their places in the coded lists, which start at the starts of the chunk.
+ */
+static void code_chunk(void *context, int index){
+    struct parallel_pass *pass = (struct parallel_pass *) context;
+    struct line_chunk *chunk = &pass->chunks[index];
+    struct coded_list inst_part, dir_part;
+    const struct syntax_tree *tree;
+    int i = chunk->first_line;
+
+    init_coded_list_part(&inst_part, pass->inst_coded_list, &chunk->inst_start);
+    init_coded_list_part(&dir_part, pass->dir_coded_list, &chunk->dir_start);
+
+    for (; i < chunk->end_line; i++){
+        tree = pass->line_trees[i];
+        if(tree == NULL || tree->lineType == error){
+            continue;
+        }
+
+        if(tree == &pass->trees[i]){
+            map_label_ids(&pass->trees[i], chunk->ids);
+        }
+        code_line(tree->lineType == instruction ? &inst_part : &dir_part, tree);
+    }
+}
+
+/*
+ * The add_sizes function adds a size to a total.
+ */
+static void add_sizes(struct coded_size *total, const struct coded_size *size){
+    total->length += size->length;
+    total->words += size->words;
+    total->runs += size->runs;
+    total->fixups += size->fixups;
+}
+
+/*
+ * The run_phase function runs a phase of the parallel first pass on all the chunks, and waits for it to end.
+ */
+static void run_phase(struct parallel_pass *pass, int threads_count, const int *order, int chunks_count,
+                      void (*phase)(void *context, int index)){
+    join_thread_pool(start_thread_pool(threads_count < chunks_count ? threads_count : chunks_count, order,
+                                       chunks_count, phase, pass));
+}
+
+/*
+ * The code_lines_in_parallel function does the work of code_lines on chunks of the lines, with the same result:
+ * 1. The workers lex their chunks, and sum the sizes of the lines of each chunk.
+ * 2. The labels of the chunks are interned in the pool of the file in the order of the chunks, so every label
+ *    gets the id it gets when the lines are lexed one after the other. The starts of the chunks are the prefix sums
+ *    of their sizes, and the coded lists are allocated once for the total sizes.
+ * 3. The workers code their chunks, every line straight to its place in the coded lists.
+ * 4. The errors and the labels are added in the order of the lines, so the messages come in the same order.
+ */
+static void code_lines_in_parallel(const struct am_source *am, struct intern_pool *names, struct symbol_table *symbols,
+                                   struct coded_list *inst_coded_list, struct coded_list *dir_coded_list,
+                                   int *errors_counter, int threads_count, int chunks_count,
+                                   struct diagnostics *diagnostics){
+    char line[MAX_LINE_SIZE+1];
+    struct parallel_pass pass;
+    struct coded_size inst_size = {0, 0, 0, 0}, dir_size = {0, 0, 0, 0}, inst_offset = {0, 0, 0, 0},
+            dir_offset = {0, 0, 0, 0};
+    struct line_chunk *chunk;
+    const struct syntax_tree *tree;
+    const struct interned_name *name;
+    int *order = (int *) malloc(chunks_count * sizeof(int)), i, j, line_errors;
+
+    pass.am = am;
+    pass.trees = (struct syntax_tree *) malloc(am->lines_count * sizeof(struct syntax_tree));
+    pass.line_trees = (const struct syntax_tree **) malloc(am->lines_count * sizeof(struct syntax_tree *));
+    pass.chunks = (struct line_chunk *) calloc(chunks_count, sizeof(struct line_chunk));
+    pass.inst_coded_list = inst_coded_list;
+    pass.dir_coded_list = dir_coded_list;
+    if(order == NULL || pass.trees == NULL || pass.line_trees == NULL || pass.chunks == NULL){
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < chunks_count; i++){
+        chunk = &pass.chunks[i];
+        chunk->first_line = (int) ((long) am->lines_count * i / chunks_count);
+        chunk->end_line = (int) ((long) am->lines_count * (i + 1) / chunks_count);
+        init_intern_pool(&chunk->names);
+        order[i] = i;
+    }
+
+    run_phase(&pass, threads_count, order, chunks_count, lex_chunk);
+
+    for (i = 0; i < chunks_count; i++){
+        chunk = &pass.chunks[i];
+
+        chunk->ids = (int *) malloc((chunk->names.names_count + 1) * sizeof(int));
+        if(chunk->ids == NULL){
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        for (j = 0; j < chunk->names.names_count; j++){
+            name = &chunk->names.names[j];
+            chunk->ids[j] = intern_name(names, name->text, name->length);
+        }
+
+        chunk->inst_start = inst_size;
+        chunk->dir_start = dir_size;
+        add_sizes(&inst_size, &chunk->inst_size);
+        add_sizes(&dir_size, &chunk->dir_size);
+    }
+
+    reserve_coded_list(inst_coded_list, &inst_size);
+    reserve_coded_list(dir_coded_list, &dir_size);
+    run_phase(&pass, threads_count, order, chunks_count, code_chunk);
+    set_coded_list_size(inst_coded_list, &inst_size);
+    set_coded_list_size(dir_coded_list, &dir_size);
+
+    for (i = 0; i < am->lines_count; i++){
+        tree = pass.line_trees[i];
+
+        if(tree == NULL){
+            (*errors_counter)++;
+            report_line_error(diagnostics, "", i + 1, "ERROR INPUT LENGTH IS TOO LONG");
+        } else if(tree->lineType == error){
+            get_printable_line(tree, am->text + am->line_starts[i], am_source_line_length(am, i), line);
+            report_line_error(diagnostics, "", i + 1, "%s - \"%s\"", get_error_message(tree->error), line);
+            *errors_counter = *errors_counter + 1;
+        } else if(tree->lineType == instruction || tree->lineType == directive){
+            line_errors = add_line_symbols(symbols, tree, tree->lineType == instruction ? inst_offset.length :
+                                                          dir_offset.length);
+            add_line_size(tree->lineType == instruction ? &inst_offset : &dir_offset, tree);
+            if(line_errors > 0 && diagnostics->stream != NULL){
+                fprintf(diagnostics->stream, "%d\n", line_errors);
+            }
+            *errors_counter = *errors_counter + line_errors;
+        }
+    }
+
+    for (i = 0; i < chunks_count; i++){
+        free_intern_pool(&pass.chunks[i].names);
+        free(pass.chunks[i].ids);
+    }
+    free(pass.chunks);
+    free(pass.line_trees);
+    free(pass.trees);
+    free(order);
+}
+
+/*
+ * A batch of lexed lines, passed from the lexer stage to the encoder stage when the lexer runs ahead.
+ * line_trees holds the syntax tree of every line (NULL for a line that is too long), the trees of the lines
+ * that were lexed by the lexer stage are in trees. new_names are the labels the lexer stage met for the first
+ * time in the batch, in the order of their ids in its pool (a line has at most 3 labels).
+ */
+struct line_batch {
+    int first_line;
+    int count;
+    struct syntax_tree trees[LEX_AHEAD_BATCH_LINES];
+    const struct syntax_tree *line_trees[LEX_AHEAD_BATCH_LINES];
+    struct interned_name new_names[3 * LEX_AHEAD_BATCH_LINES];
+    int new_names_count;
+};
+
+/*
+ * The lexer and the encoder share the expanded source and two rings: full passes the lexed batches
+ * to the encoder, and empty returns them to the lexer once they are coded. The lexer stage interns the labels
+ * in its own pool, which the encoder stage never reads.
+ */
+struct lexer_rings {
+    const struct am_source *am;
+    struct intern_pool names;
+    struct spsc_ring full;
+    struct spsc_ring empty;
+};
+
+/*
+ * The lex_stage function is the lexer stage: the lines are lexed in batches, and every batch is passed to
+ * the encoder stage, followed by NULL after the last line.
+ */
+static void lex_stage(void *context, int task){
+    struct lexer_rings *rings = (struct lexer_rings *) context;
+    const struct am_source *am = rings->am;
+    struct line_batch *batch;
+    int line = 0, first_new_name;
+
+    while (line < am->lines_count){
+        batch = (struct line_batch *) pop_from_ring(&rings->empty);
+        batch->first_line = line;
+        batch->count = 0;
+        first_new_name = rings->names.names_count;
+
+        for (; batch->count < LEX_AHEAD_BATCH_LINES && line < am->lines_count; batch->count++, line++){
+            batch->line_trees[batch->count] = NULL;
+            if(!is_line_too_long(am, line)){
+                batch->line_trees[batch->count] = am->line_trees[line];
+                if(am->line_trees[line] == NULL){
+                    build_syntax_tree_from_line(&batch->trees[batch->count], am->text + am->line_starts[line],
+                                                am_source_line_length(am, line), &rings->names);
+                    batch->line_trees[batch->count] = &batch->trees[batch->count];
+                }
+            }
+        }
+
+        /*
+         * The texts of the names are in the arena of the pool, which doesn't move them
+         */
+        batch->new_names_count = rings->names.names_count - first_new_name;
+        memcpy(batch->new_names, rings->names.names + first_new_name,
+               batch->new_names_count * sizeof(struct interned_name));
+
+        push_to_ring(&rings->full, batch);
+    }
+
+    push_to_ring(&rings->full, NULL);
+}
+
+/*
+ * The code_lines_lexed_ahead function does the work of code_lines in two stages: the lexer stage runs on a worker
+ * and the encoder stage on the calling thread, connected by two rings. The encoder interns
+ * the new labels of every batch in the pool of the file in the order the lexer met them, so every label gets
+ * the id it gets when the lines are lexed one after the other, and codes the lines in order (with one-pass mode).
+ */
+static void code_lines_lexed_ahead(const struct am_source *am, struct intern_pool *names,
+                                   struct symbol_table *symbols, struct coded_list *inst_coded_list,
+                                   struct coded_list *dir_coded_list, int *errors_counter, bool one_pass,
+                                   struct diagnostics *diagnostics){
+    struct line_batch *batches = (struct line_batch *) malloc(LEX_AHEAD_BATCHES * sizeof(struct line_batch));
+    struct line_batch *batch;
+    struct lexer_rings rings;
+    struct thread_pool *lexer;
+    int *ids = NULL, ids_count = 0, ids_capacity = 0, order = 0, i;
+
+    if(batches == NULL){
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    rings.am = am;
+    init_intern_pool(&rings.names);
+    init_spsc_ring(&rings.full, LEX_AHEAD_BATCHES * 2);
+    init_spsc_ring(&rings.empty, LEX_AHEAD_BATCHES);
+    for (i = 0; i < LEX_AHEAD_BATCHES; i++){
+        push_to_ring(&rings.empty, &batches[i]);
+    }
+
+    lexer = start_thread_pool(1, &order, 1, lex_stage, &rings);
+
+    while ((batch = (struct line_batch *) pop_from_ring(&rings.full)) != NULL){
+        if(ids_count + batch->new_names_count > ids_capacity){
+            int *grown;
+
+            ids_capacity = (ids_count + batch->new_names_count) * 2;
+            grown = (int *) realloc(ids, ids_capacity * sizeof(int));
+            if(grown == NULL){
+                printf("Error: Memory allocation failed.\n");
+                exit(-1);
+            }
+            ids = grown;
+        }
+        for (i = 0; i < batch->new_names_count; i++){
+            ids[ids_count++] = intern_name(names, batch->new_names[i].text, batch->new_names[i].length);
+        }
+
+        for (i = 0; i < batch->count; i++){
+            if(batch->line_trees[i] == &batch->trees[i] && batch->trees[i].lineType != error){
+                map_label_ids(&batch->trees[i], ids);
+            }
+            code_source_line(am, batch->first_line + i + 1, batch->line_trees[i], symbols, inst_coded_list,
+                             dir_coded_list, errors_counter, one_pass, diagnostics);
+        }
+
+        push_to_ring(&rings.empty, batch);
+    }
+
+    join_thread_pool(lexer);
+
+    free(ids);
+    free_spsc_ring(&rings.full);
+    free_spsc_ring(&rings.empty);
+    free_intern_pool(&rings.names);
+    free(batches);
+}
+
+/*
+ * The first_pass function performs the first pass analysis of the assembly file. This includes building
+ * the syntax tree for each line (lines of macros reuse the syntax tree built by am_builder), classifying the line type (instruction, directive, or error), and
+ * adding the codes to the appropriate list (inst_coded_list or dir_coded_list). The function also
+ * adds the symbols to the symbol table, and resolves and verifies them once all the lines were read.
+ * The function increments the error_counter for each error encountered during these processes.
+ * In one-pass mode the words that use a label are patched as soon as the label is declared, so only the words
+ * that use external (or undeclared) labels are left for the second pass.
+ * A large source is split into chunks that are lexed and coded on threads_count workers (see code_lines_in_parallel),
+ * the result is the same. In lex-ahead mode the lexing and the coding overlap on two threads
+ * (see code_lines_lexed_ahead). The macros are expanded before, and the files are written after.
+ *
+ * @param: const struct am_source *am - The expanded source (the .am lines) to be analyzed.
+ * @param: struct intern_pool *names - The pool the labels of the lines are interned in.
+ * @param: struct symbol_table *symbols - The symbol table.
+ * @param: struct coded_list *inst_coded_list - The list of instruction codes.
+ * @param: struct coded_list *dir_coded_list - The list of directive codes.
+ * @param: int *errors_counter - Pointer to the counter of the errors found during the first pass.
+ * @param: bool one_pass - If the words that use labels are backpatched during the pass.
+ * @param: int threads_count - The amount of workers the lines can be coded on.
+ * @param: bool lex_ahead - If the lexer runs as a stage of its own, on another thread.
+ * @param: struct diagnostics *diagnostics - Where the errors are reported.
+ */
+void first_pass(const struct am_source *am, struct intern_pool *names, struct symbol_table *symbols,
+        struct coded_list *inst_coded_list, struct coded_list *dir_coded_list,
+                int *errors_counter, bool one_pass, int threads_count, bool lex_ahead,
+                struct diagnostics *diagnostics){
+    int chunks_count = am->lines_count / MIN_CHUNK_LINES;
+
+    if(chunks_count > threads_count * CHUNKS_PER_THREAD){
+        chunks_count = threads_count * CHUNKS_PER_THREAD;
+    }
+
+    /*
+     * Backpatching follows the lines in order, so one-pass mode codes the lines one after the other
+     */
+    if(lex_ahead){
+        code_lines_lexed_ahead(am, names, symbols, inst_coded_list, dir_coded_list, errors_counter, one_pass,
+                               diagnostics);
+    } else if(threads_count > 1 && chunks_count > 1 && !one_pass){
+        code_lines_in_parallel(am, names, symbols, inst_coded_list, dir_coded_list, errors_counter,
+                               threads_count, chunks_count, diagnostics);
+    } else {
+        code_lines(am, names, symbols, inst_coded_list, dir_coded_list, errors_counter, one_pass, diagnostics);
+    }
+
+    /*
+     * The directives come after the instructions, and the code starts at BASE_ADDRESS
+     */
+    *errors_counter = *errors_counter + resolve_symbols(symbols, inst_coded_list->length, BASE_ADDRESS);
+    if(one_pass){
+        relocate_data_fixups(symbols, inst_coded_list);
+    }
+
+    /*
+    * Check if the total length of the instruction and directive coded lists exceeds the maximum memory size.
+    * If it does, increment the errors counter and print an error message indicating memory overflow.
+    */
+    if(inst_coded_list->length + dir_coded_list->length > MAX_MEMORY_SIZE){
+        (*errors_counter)++;
+        report_error(diagnostics, "ERROR: Memory Overflow");
+    }
+
+/*
+    printf("---------\n");
+    print_symbols(symbols);
+    printf("---------\n");
+
+    print_codes(inst_coded_list);
+*/
+}
@@ -0,0 +1,172 @@
+/*
+ * The intern pool gives every label of an assembly a dense integer id when the label is first read,
+ * so the rest of the assembler compares and indexes ids instead of strings.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "intern_pool.h"
+#include "utils.h"
+
+#define INITIAL_SLOTS_COUNT 64
+
+/*
+ * Function: init_intern_pool
+ * --------------------------
+ * Initializes an empty pool.
+ *
+ * pool: The pool.
+ */
+void init_intern_pool(struct intern_pool *pool) {
+    pool->names = NULL;
+    pool->names_count = 0;
+    pool->names_capacity = 0;
+    pool->slots = (int *) calloc(INITIAL_SLOTS_COUNT, sizeof(int));
+    pool->slots_count = INITIAL_SLOTS_COUNT;
+    pool->arena.head = NULL;
+    pool->arena.current = NULL;
+
+    if (pool->slots == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+}
+
+/*
+ * Function: free_intern_pool
+ * --------------------------
+ * Frees the memory of the pool, the ids and names it gave are no longer valid.
+ *
+ * pool: The pool.
+ */
+void free_intern_pool(struct intern_pool *pool) {
+    free(pool->names);
+    free(pool->slots);
+    free_arena(&pool->arena);
+
+    pool->names = NULL;
+    pool->slots = NULL;
+    pool->names_count = 0;
+    pool->names_capacity = 0;
+    pool->slots_count = 0;
+}
+
+/*
+ * Function: get_slot
+ * ------------------
+ * Finds the slot of a name: the slot that holds it, or the empty slot where it should be added.
+ *
+ * pool: The pool.
+ * str: The name, it doesn't have to be null terminated.
+ * length: The length of the name.
+ * hash: The hash of the name.
+ *
+ * returns: The index of the slot.
+ */
+static int get_slot(const struct intern_pool *pool, const char *str, int length, unsigned long hash) {
+    int slot = (int) (hash & (pool->slots_count - 1));
+    const struct interned_name *name;
+
+    while (pool->slots[slot] != 0) {
+        name = &pool->names[pool->slots[slot] - 1];
+        if (name->hash == hash && name->length == length && memcmp(name->text, str, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) & (pool->slots_count - 1);
+    }
+
+    return slot;
+}
+
+/*
+ * Function: grow_slots
+ * --------------------
+ * Doubles the amount of slots and places the names again.
+ *
+ * pool: The pool.
+ */
+static void grow_slots(struct intern_pool *pool) {
+    const struct interned_name *name;
+    int i = 0;
+
+    free(pool->slots);
+    pool->slots_count *= 2;
+    pool->slots = (int *) calloc(pool->slots_count, sizeof(int));
+    if (pool->slots == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    for (; i < pool->names_count; ++i) {
+        name = &pool->names[i];
+        pool->slots[get_slot(pool, name->text, name->length, name->hash)] = i + 1;
+    }
+}
+
+/*
+ * Function: intern_name
+ * ---------------------
+ * Returns the id of a name, and adds the name to the pool if it's new.
+ *
+ * pool: The pool.
+ * str: The name, it doesn't have to be null terminated.
+ * length: The length of the name.
+ *
+ * returns: The id of the name.
+ */
+int intern_name(struct intern_pool *pool, const char *str, int length) {
+    unsigned long hash = hash_string(str, length);
+    int slot = get_slot(pool, str, length, hash);
+    struct interned_name *name;
+    char *text;
+
+    if (pool->slots[slot] != 0) {
+        return pool->slots[slot] - 1;
+    }
+
+    if (pool->names_count == pool->names_capacity) {
+        struct interned_name *grown;
+
+        pool->names_capacity = pool->names_capacity == 0 ? 32 : pool->names_capacity * 2;
+        grown = (struct interned_name *) realloc(pool->names, pool->names_capacity * sizeof(struct interned_name));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        pool->names = grown;
+    }
+
+    text = (char *) arena_alloc(&pool->arena, length + 1);
+    memcpy(text, str, length);
+    text[length] = '\0';
+
+    name = &pool->names[pool->names_count];
+    name->text = text;
+    name->length = length;
+    name->hash = hash;
+    pool->slots[slot] = ++pool->names_count;
+
+    /*
+     * Keep at least half of the slots empty
+     */
+    if (pool->names_count * 2 > pool->slots_count) {
+        grow_slots(pool);
+    }
+
+    return pool->names_count - 1;
+}
+
+/*
+ * Function: get_interned_name
+ * ---------------------------
+ * Returns the name of an id.
+ *
+ * pool: The pool.
+ * id: The id, given by intern_name.
+ *
+ * returns: The null terminated name.
+ */
+const char *get_interned_name(const struct intern_pool *pool, int id) {
+    return pool->names[id].text;
+}
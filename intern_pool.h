@@ -0,0 +1,33 @@
+#ifndef ASSEMBLER_INTERN_POOL_H
+#define ASSEMBLER_INTERN_POOL_H
+
+#include "arena.h"
+
+/*
+ * A name in the pool, its text is kept in the arena of the pool and is null terminated.
+ */
+struct interned_name {
+    const char *text;
+    int length;
+    unsigned long hash;
+};
+
+/*
+ * Maps every distinct name (label) of an assembly to a dense integer id, the first name gets 0.
+ * The names are found by an open addressing hash table, a slot holds the id of a name plus one, an empty slot holds 0.
+ */
+struct intern_pool {
+    struct interned_name *names;
+    int names_count;
+    int names_capacity;
+    int *slots;
+    int slots_count;
+    struct arena arena;
+};
+
+void init_intern_pool(struct intern_pool *pool);
+void free_intern_pool(struct intern_pool *pool);
+int intern_name(struct intern_pool *pool, const char *str, int length);
+const char *get_interned_name(const struct intern_pool *pool, int id);
+
+#endif
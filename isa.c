@@ -0,0 +1,45 @@
+/*
+ * The instruction set of the machine, described once in a table indexed by the op code.
+ * The lexer, the parser and the encoder all read the instructions from this table.
+ */
+
+#include <stdlib.h>
+#include "isa.h"
+
+static const struct instruction_info instructions[] = {
+        {"",     0, ADDRESSING_NONE,  ADDRESSING_NONE,     -1},
+        {"mov",  2, ADDRESSING_ALL,   ADDRESSING_WRITABLE, 0},
+        {"cmp",  2, ADDRESSING_ALL,   ADDRESSING_ALL,      1},
+        {"add",  2, ADDRESSING_ALL,   ADDRESSING_WRITABLE, 2},
+        {"sub",  2, ADDRESSING_ALL,   ADDRESSING_WRITABLE, 3},
+        {"not",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 4},
+        {"clr",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 5},
+        {"lea",  2, ADDRESSING_LABEL, ADDRESSING_WRITABLE, 6},
+        {"inc",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 7},
+        {"dec",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 8},
+        {"jmp",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 9},
+        {"bne",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 10},
+        {"red",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 11},
+        {"prn",  1, ADDRESSING_NONE,  ADDRESSING_ALL,      12},
+        {"jsr",  1, ADDRESSING_NONE,  ADDRESSING_WRITABLE, 13},
+        {"rts",  0, ADDRESSING_NONE,  ADDRESSING_NONE,     14},
+        {"stop", 0, ADDRESSING_NONE,  ADDRESSING_NONE,     15}
+};
+
+#define AMOUNT_OF_INSTRUCTIONS ((int) (sizeof(instructions) / sizeof(struct instruction_info)))
+
+/*
+ * Function: get_instruction_info
+ * ------------------------------
+ * Returns the description of an instruction.
+ *
+ * op_code: The op code of the instruction.
+ *
+ * returns: The description of the instruction, or NULL if there is no instruction with this op code.
+ */
+const struct instruction_info *get_instruction_info(enum op_code op_code) {
+    if (op_code < op_code_mov || op_code >= AMOUNT_OF_INSTRUCTIONS) {
+        return NULL;
+    }
+    return &instructions[op_code];
+}
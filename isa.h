@@ -0,0 +1,30 @@
+#ifndef ASSEMBLER_ISA_H
+#define ASSEMBLER_ISA_H
+
+#include "lexer.h"
+
+/*
+ * The bit of an addressing method in the addressing masks of an instruction.
+ */
+#define ADDRESSING_BIT(type) ((type) > 0 ? 1 << (type) : 0)
+
+#define ADDRESSING_ALL (ADDRESSING_BIT(immediate) | ADDRESSING_BIT(direct) | ADDRESSING_BIT(direct_register))
+#define ADDRESSING_WRITABLE (ADDRESSING_BIT(direct) | ADDRESSING_BIT(direct_register))
+#define ADDRESSING_LABEL ADDRESSING_BIT(direct)
+#define ADDRESSING_NONE 0
+
+/*
+ * The description of an instruction of the machine:
+ * how many operands it takes, which addressing methods are legal for each operand, and its op code bits.
+ */
+struct instruction_info {
+    char name[5];
+    int operands_count;
+    int src_addressing;
+    int des_addressing;
+    int op_code_bits;
+};
+
+const struct instruction_info *get_instruction_info(enum op_code op_code);
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * The reserved words of the language (instructions, directives and registers) are found with a perfect hash:
+ * every reserved word has its own slot in the table, so a word is classified with a single comparison.
+ */
+
+#include <string.h>
+#include "keywords.h"
+
+#define KEYWORDS_TABLE_SIZE 64
+
+/*
+ * The hash uses the first, second and last characters and the length of the word.
+ * The coefficients were chosen so that no two reserved words share a slot,
+ * adding a reserved word requires checking that its slot is still free.
+ */
+#define KEYWORD_HASH(str, length) \
+    ((3 * (unsigned char) (str)[0] + 11 * (unsigned char) (str)[1] + \
+      5 * (unsigned char) (str)[(length) - 1] + (length)) & (KEYWORDS_TABLE_SIZE - 1))
+
+static const struct keyword keywords_table[KEYWORDS_TABLE_SIZE] = {
+        {".data", 5, keyword_directive, data}, /* 0 */
+        {"", 0, keyword_none, 0}, /* 1 */
+        {"", 0, keyword_none, 0}, /* 2 */
+        {"lea", 3, keyword_instruction, op_code_lea}, /* 3 */
+        {".entry", 6, keyword_directive, entry}, /* 4 */
+        {".string", 7, keyword_directive, string}, /* 5 */
+        {"", 0, keyword_none, 0}, /* 6 */
+        {"", 0, keyword_none, 0}, /* 7 */
+        {"", 0, keyword_none, 0}, /* 8 */
+        {"stop", 4, keyword_instruction, op_code_stop}, /* 9 */
+        {"clr", 3, keyword_instruction, op_code_clr}, /* 10 */
+        {"cmp", 3, keyword_instruction, op_code_cmp}, /* 11 */
+        {"", 0, keyword_none, 0}, /* 12 */
+        {"sub", 3, keyword_instruction, op_code_sub}, /* 13 */
+        {".extern", 7, keyword_directive, external}, /* 14 */
+        {"", 0, keyword_none, 0}, /* 15 */
+        {"", 0, keyword_none, 0}, /* 16 */
+        {"", 0, keyword_none, 0}, /* 17 */
+        {"", 0, keyword_none, 0}, /* 18 */
+        {"", 0, keyword_none, 0}, /* 19 */
+        {"rts", 3, keyword_instruction, op_code_rts}, /* 20 */
+        {"", 0, keyword_none, 0}, /* 21 */
+        {"not", 3, keyword_instruction, op_code_not}, /* 22 */
+        {"", 0, keyword_none, 0}, /* 23 */
+        {"", 0, keyword_none, 0}, /* 24 */
+        {"@r0", 3, keyword_register, 0}, /* 25 */
+        {"", 0, keyword_none, 0}, /* 26 */
+        {"", 0, keyword_none, 0}, /* 27 */
+        {"bne", 3, keyword_instruction, op_code_bne}, /* 28 */
+        {"mov", 3, keyword_instruction, op_code_mov}, /* 29 */
+        {"@r1", 3, keyword_register, 1}, /* 30 */
+        {"prn", 3, keyword_instruction, op_code_prn}, /* 31 */
+        {"jmp", 3, keyword_instruction, op_code_jmp}, /* 32 */
+        {"", 0, keyword_none, 0}, /* 33 */
+        {"", 0, keyword_none, 0}, /* 34 */
+        {"@r2", 3, keyword_register, 2}, /* 35 */
+        {"red", 3, keyword_instruction, op_code_red}, /* 36 */
+        {"", 0, keyword_none, 0}, /* 37 */
+        {"add", 3, keyword_instruction, op_code_add}, /* 38 */
+        {"inc", 3, keyword_instruction, op_code_inc}, /* 39 */
+        {"@r3", 3, keyword_register, 3}, /* 40 */
+        {"", 0, keyword_none, 0}, /* 41 */
+        {"", 0, keyword_none, 0}, /* 42 */
+        {"", 0, keyword_none, 0}, /* 43 */
+        {"jsr", 3, keyword_instruction, op_code_jsr}, /* 44 */
+        {"@r4", 3, keyword_register, 4}, /* 45 */
+        {"", 0, keyword_none, 0}, /* 46 */
+        {"", 0, keyword_none, 0}, /* 47 */
+        {"", 0, keyword_none, 0}, /* 48 */
+        {"", 0, keyword_none, 0}, /* 49 */
+        {"@r5", 3, keyword_register, 5}, /* 50 */
+        {"", 0, keyword_none, 0}, /* 51 */
+        {"", 0, keyword_none, 0}, /* 52 */
+        {"dec", 3, keyword_instruction, op_code_dec}, /* 53 */
+        {"", 0, keyword_none, 0}, /* 54 */
+        {"@r6", 3, keyword_register, 6}, /* 55 */
+        {"", 0, keyword_none, 0}, /* 56 */
+        {"", 0, keyword_none, 0}, /* 57 */
+        {".space", 6, keyword_directive, space}, /* 58 */
+        {"", 0, keyword_none, 0}, /* 59 */
+        {"@r7", 3, keyword_register, 7}, /* 60 */
+        {"", 0, keyword_none, 0}, /* 61 */
+        {"", 0, keyword_none, 0}, /* 62 */
+        {"", 0, keyword_none, 0}  /* 63 */
+};
+
+/*
+ * Function: find_keyword
+ * ----------------------
+ * Finds the reserved word that equals a given word.
+ *
+ * str: The word, it doesn't have to be null terminated.
+ * length: The length of the word.
+ *
+ * returns: The reserved word, or NULL if the word isn't reserved.
+ */
+const struct keyword *find_keyword(const char *str, int length) {
+    const struct keyword *keyword;
+
+    if (length < 2) {
+        return NULL;
+    }
+
+    keyword = &keywords_table[KEYWORD_HASH(str, length)];
+    if (keyword->length != length || memcmp(keyword->name, str, length) != 0) {
+        return NULL;
+    }
+    return keyword;
+}
@@ -0,0 +1,26 @@
+#ifndef ASSEMBLER_KEYWORDS_H
+#define ASSEMBLER_KEYWORDS_H
+
+#include "lexer.h"
+
+enum keyword_type {
+    keyword_none,
+    keyword_instruction,
+    keyword_directive,
+    keyword_register
+};
+
+/*
+ * A reserved word of the language.
+ * The value is the op code of an instruction, the type of a directive, or the number of a register.
+ */
+struct keyword {
+    char name[8];
+    int length;
+    enum keyword_type type;
+    int value;
+};
+
+const struct keyword *find_keyword(const char *str, int length);
+
+#endif
@@ -1,523 +1,604 @@
-#include <stdlib.h>
-#include "lexer.h"
-#include "string.h"
-#include "ctype.h"
-#include "parser.h"
-#include "utils.h"
-
-void escape_white_chars(const char** str) {
-    int i = 0;
-
-    while((*str)[i] != '\0' && isspace((*str)[i])) {
-        i++;
-    }
-    *str = *str + i;
-}
-
-/*
- * Function that verifies if the word in the string represents an integer number.
- */
-static bool is_a_number(char *str){
-    int i = 0;
-
-    /*
-     * Check if it starts with + or -
-     */
-    if(strlen(str) > 1){
-        if( (str[0] != '+' && str[0] != '-' && !isdigit(str[0]))){
-            return false;
-        } else {
-            /*
-             * If it does, start the loop from index 2
-             */
-            i++;
-        }
-    }
-    for (; i < strlen(str); ++i) {
-        if(!isdigit(str[i]))
-            return false;
-    }
-
-    return true;
-}
-
-/*
- * Extract the first word from a sentence (line) to the word.
- * A word is defined as "all the letters until the first space".
- */
-static void get_first_word(const char *line, char *word){
-    int i = 0;
-    for (; !isspace(line[i]) && line[i] != '\0' ; i++) {
-    }
-    strncpy(word, line, i);
-    word[i] = '\0';
-}
-
-/*
- * Extract the first parameter from a sentence (line) to the word.
- * A parameter is defined as "all the letters until the first comma, if there is no comma then the whole word".
- */
-static bool get_first_parameter(struct syntax_tree *st, const char *line, char *word){
-    int comma_index = char_at(line, ',');
-
-    if(comma_index == -1){
-        comma_index = strlen(line);
-    }
-    strncpy(word, line, comma_index);
-    word[comma_index] = '\0';
-
-    if(strlen(word) == 0){
-        SET_ERROR("ERROR MISSING PARAMETER")
-    }
-
-    return true;
-}
-
-/*
- * Check if the word (input) is a valid label:
- * - Starts with a letter
- * - Does not equal a reserved word
- */
-static bool is_label(struct syntax_tree *st, const char *input){
-    if(!is_not_equal_to_reserved_word(input)){
-        strcpy(st->error_message, "ERROR LABEL IS INVALID, RESERVED WORD USED");
-        st->lineType = error;
-    } else if(!(input[0] >= 'A' && input[0] <= 'z')){
-        strcpy(st->error_message, "ERROR LABEL IS INVALID");
-        st->lineType = error;
-    }
-    return st->lineType != error;
-}
-
-/*
- * Check if the word (input) is a declaration of a label
- * Example: "LABEL:" , "WORD:"
- */
-static bool is_declaration_label(const char *input){
-    return input[strlen(input) - 1] == ':';
-}
-
-/*
- * Function that removes unnecessary spaces from a string.
- * Unnecessary spaces are:
- * - Two spaces together, e.g., "word[SPACE][SPACE]word"
- * - Leading or trailing spaces, e.g., "[SPACE][SPACE]word" or "word[SPACE][SPACE]"
- */
-static bool remove_white_char_from_str(struct syntax_tree *st, char *str){
-    char* temp = malloc((strlen(str) + 1) * sizeof(char));
-    int i = 0, j = 0, white_char_counter = 0, is_comma_exist = false;
-
-    if(str == NULL || strlen(str) == 0){
-        return true;
-    }
-
-    for (; i < strlen(str); ++i) {
-        if(!isspace(str[i])){
-            if(str[i] != ','){
-                if(white_char_counter != 0 && !is_comma_exist){
-                    SET_ERROR("ERROR MISSING COMMA")
-                }
-                white_char_counter = 0;
-                is_comma_exist = false;
-            } else {
-                if(is_comma_exist){
-                    SET_ERROR("ERROR TOO MANY COMMAS OR MISSING PARAMETER")
-                }
-                is_comma_exist = true;
-            }
-
-            temp[j] = str[i];
-            j++;
-        } else {
-            white_char_counter++;
-        }
-    }
-
-    temp[j] = '\0';
-    if(temp[strlen(temp) - 1] == ','){
-        SET_ERROR("ERROR MISSING PARAMETER OR TOO MANY COMMAS")
-    }
-    if(strcmp(str, temp) != 0){
-        strcpy(str, temp);
-    }
-
-    free(temp);
-    return true;
-}
-
-/*
- * Extract a string from a sentence.
- * A string is enclosed in apostrophes.
- * Example: "string "word""
- */
-static bool extract_string(struct syntax_tree *st, const char *line){
-    char temp[MAX_LINE_SIZE];
-    int i;
-
-    escape_white_chars(&line);
-
-    for (i = strlen(line) - 1; i >= 0 ; i--) {
-        if(!isspace(line[i])) {
-            break;
-        }
-    }
-    strncpy(temp, line, i + 1);
-    temp[i + 1] = '\0';
-
-    if(strlen(temp) == 0){
-        SET_ERROR("ERROR MISSING STRING")
-    }
-    if(temp[0] != '\"'){
-        SET_ERROR("ERROR STRING NOT OPEN")
-    }
-    if(temp[strlen(temp) - 1] != '\"'){
-
-        SET_ERROR("ERROR STRING NOT CLOSED")
-    }
-
-    /*
-     * Remove the quotes from the string
-     */
-    strcpy(st->dir_or_inst.dir.dir_info.str, temp + 1);
-    st->dir_or_inst.dir.dir_info.str[strlen(st->dir_or_inst.dir.dir_info.str) - 1] = '\0';
-
-    return true;
-}
-
-/*
- * Extract a list of integers to an array.
- * The result is stored in st->dir_or_inst->dir->dir_info->num_arr->int_arr.
- * Example of a list of integers: "1,2,3,4,5,6,7"
- */
-static int extract_ints(struct syntax_tree *st, const char *line){
-    char str_num[MAX_LABEL_SIZE + 1];
-    int i = 0, num;
-    escape_white_chars(&line);
-
-    if(strlen(line) == 0){
-        SET_ERROR("ERROR NOT ENOUGH VARIABLES")
-    }
-
-    for (; i < MAX_VARS && strlen(line) > 0; ++i) {
-        get_first_parameter(st, line, str_num);
-
-        if((strlen(str_num) == 0 && strlen(line) != 0 ) || !is_a_number(str_num)){
-            SET_ERROR("ERROR INPUT ISN'T A NUMBER OR INPUT IS EMPTY")
-        } else {
-            /*
-             * No more parameters to read
-             */
-            if(strlen(str_num) == 0)
-                break;
-
-            num = atoi(str_num);
-
-            if(num < -2048 || num > 2047) {
-                st->lineType = error;
-                strcpy(st->error_message, "ERROR NUMBER OUT OF RANGE");
-                num = -1;
-            }
-
-            st->dir_or_inst.dir.dir_info.num_arr.int_arr[i] = num;
-            st->dir_or_inst.dir.dir_info.num_arr.arr_length = i + 1;
-            /*
-             * Escape the comma
-             */
-            if(strlen(line) != strlen(str_num)){
-                line += 1;
-            }
-            line += strlen(str_num);;
-        }
-    }
-
-    return -1;
-}
-
-/*
- * Extract the source and destination parameters from line to st->dir_or_inst->inst->one_or_two_parameters->two_parameters.
- * Example of two parameters: "src,des"
- */
-static bool extract_two_parameters(struct syntax_tree *st, const char *line) {
-    char parameter[MAX_LABEL_SIZE + 1];
-    int comma_index;
-
-    /*
-     * First parameter
-     */
-    get_first_parameter(st, line, parameter);
-    line += strlen(parameter) + 1;
-
-    if (strlen(parameter) == 0) {
-        SET_ERROR("ERROR MISSING PARAMETER")
-    } else {
-        strcpy(st->dir_or_inst.inst.one_or_two_parameters.two_parameters.src_parameter, parameter);
-
-        /*
-         * Second parameter
-         */
-        comma_index = char_at(line, ',');
-        if (comma_index != -1) {
-            SET_ERROR("ERROR TOO MANY VARIABLES")
-        } else {
-            escape_white_chars(&line);
-
-            get_first_parameter(st, line, parameter);
-            strcpy(st->dir_or_inst.inst.one_or_two_parameters.two_parameters.des_parameter, parameter);
-        }
-
-    }
-
-    return true;
-}
-
-/*
- * Extract the destination parameter from line to st->dir_or_inst->inst->one_or_two_parameters->one_parameter->parameter.
- * Example of parameter: "des"
- */
-static int extract_single_parameter(struct syntax_tree *st, const char *line){
-    if(char_at(line, ',') != -1){
-        SET_ERROR("ERROR TOO MANY VARIABLES")
-    } else if(strlen(line) == 0) {
-        SET_ERROR("ERROR MISSING VARIABLE")
-    }else {
-        strcpy(st->dir_or_inst.inst.one_or_two_parameters.one_parameter.parameter, line);
-    }
-    return true;
-}
-
-/*
- * Extract a label from line to st->dir_or_inst->dir->dir_info->label.
- * Example of parameter: "label"
- */
-static bool extract_single_label(struct syntax_tree *st, const char *line){
-    if(char_at(line, ',') != -1){
-        SET_ERROR("ERROR TOO MANY PARAMETERS")
-    }
-    if(is_label(st, line)){
-        strcpy(st->dir_or_inst.dir.dir_info.label, line);
-    } else if(strlen(line) == 0){
-        SET_ERROR("ERROR MISSING LABEL")
-    } else {
-        SET_ERROR("ERROR NOT A VALID LABEL")
-    }
-
-    return true;
-}
-
-/*
- * The function navigates the syntax tree and calls the correct extracting function based on the type of input.
- */
-static bool get_parameters_by_type(struct syntax_tree *st, const char *line) {
-    if(st->lineType == directive){
-        if(st->dir_or_inst.dir.dirType == string){
-            extract_string(st, line);
-        } else if(st->dir_or_inst.dir.dirType == data){
-            extract_ints(st, line);
-        } else if(st->dir_or_inst.dir.dirType == entry ||
-                  st->dir_or_inst.dir.dirType == external){
-            extract_single_label(st, line);
-        }
-    } else if (st->lineType == instruction){
-        /*
-         * Double parameter
-         */
-        if(st->dir_or_inst.inst.opCode == op_code_mov ||
-           st->dir_or_inst.inst.opCode == op_code_cmp ||
-           st->dir_or_inst.inst.opCode == op_code_add ||
-           st->dir_or_inst.inst.opCode == op_code_sub ||
-           st->dir_or_inst.inst.opCode == op_code_lea){
-            extract_two_parameters(st, line);
-        }
-            /*
-             * Single parameter
-             */
-        else if(st->dir_or_inst.inst.opCode == op_code_not ||
-                st->dir_or_inst.inst.opCode == op_code_clr ||
-                st->dir_or_inst.inst.opCode == op_code_inc ||
-                st->dir_or_inst.inst.opCode == op_code_dec ||
-                st->dir_or_inst.inst.opCode == op_code_jmp ||
-                st->dir_or_inst.inst.opCode == op_code_bne ||
-                st->dir_or_inst.inst.opCode == op_code_red ||
-                st->dir_or_inst.inst.opCode == op_code_prn ||
-                st->dir_or_inst.inst.opCode == op_code_jsr){
-            extract_single_parameter(st, line);
-        }
-            /*
-             * Non-parameter
-             */
-        else if(st->dir_or_inst.inst.opCode == op_code_rts ||
-                st->dir_or_inst.inst.opCode == op_code_stop){
-            if(line != NULL && strlen(line) != 0){
-                SET_ERROR("ERROR TOO MANY PARAMETERS")
-            }
-        }
-    }
-
-    return true;
-}
-
-/*
- * Classify the syntax tree line type:
- * - directive: starts with a dot, optional inputs - ".string", ".data", ".entry", ".extern"
- * - instruction: "mov", "cmp", "add", "sub", "not", "clr", "lea", "inc", "dec", "jmp", "bne", "red", "prn", "jsr", "rts", "stop"
- * - comment: starts with ';', e.g., ";comment line"
- */
-static int set_type_of_input(struct syntax_tree *st, char *input){
-    typedef struct {
-        char input[MAX_LABEL_SIZE + 1];
-        int i;
-    }type_command;
-    type_command dc[] = {
-            {".string", string},
-            {".data", data},
-            {".entry", entry},
-            {".extern", external}
-    };
-    type_command ic[] = {
-            {"mov", op_code_mov},
-            {"cmp", op_code_cmp},
-            {"add", op_code_add},
-            {"sub", op_code_sub},
-            {"not", op_code_not},
-            {"clr", op_code_clr},
-            {"lea", op_code_lea},
-            {"inc", op_code_inc},
-            {"dec", op_code_dec},
-            {"jmp", op_code_jmp},
-            {"bne", op_code_bne},
-            {"red", op_code_red},
-            {"prn", op_code_prn},
-            {"jsr", op_code_jsr},
-            {"rts", op_code_rts},
-            {"stop", op_code_stop}
-    };
-    int i;
-
-    if(input == NULL || input[0] == '\n'){
-
-    }else if(input[0] == '.'){
-        st->lineType = directive;
-        st->dir_or_inst.dir.dirType = -1;
-
-        i = 0;
-        for (; i < sizeof(dc)/ sizeof(type_command); i++) {
-            if(strcmp(dc[i].input, input) == 0){
-                st->dir_or_inst.dir.dirType = dc[i].i;
-                break;
-            }
-        }
-        if(st->dir_or_inst.dir.dirType == -1){
-            SET_ERROR("ERROR INVALID DECLARATION")
-        }
-
-    } else if(input[0] == ';') {
-        st->lineType = comment;
-    } else{
-        st->lineType = instruction;
-
-
-        i = 0;
-
-        for (; i < sizeof(ic) / sizeof(type_command); ++i) {
-            if(strcmp(ic[i].input, input) == 0){
-                st->dir_or_inst.inst.opCode = ic[i].i;
-                break;
-            }
-        }
-
-        if(i == sizeof(ic) / sizeof(type_command)){
-            SET_ERROR("ERROR UNRECOGNIZED COMMAND")
-        }
-    }
-
-    return -1;
-}
-
-/*
- * Initialize all the fields of the syntax tree based on the input (line).
- * Set the declaration label, type of the command line (directive or instruction), and the variables of the current command.
- */
-void build_syntax_tree_from_line(struct syntax_tree *st, char *line){
-    char word[MAX_LABEL_SIZE + 1];
-    clear_syntax_tree(st);
-
-    strcpy(st->label, "");
-    st->lineType = 0;
-    if(line[strlen(line) - 1] == '\n'){
-        line[strlen(line) - 1] = '\0';
-    }
-
-    escape_white_chars((const char**)&line);
-
-    /*
-     * Check if the sentence starts with a label
-     */
-    get_first_word(line, word);
-    line += strlen(word);
-    escape_white_chars((const char**)&line);
-
-    if(is_declaration_label(word)){
-        word[strlen(word) - 1] = '\0';
-        if(!is_label(st, word)){
-            return;
-        }
-
-        if(strcmp(line, "") == 0) {
-            st->lineType = error;
-            strcpy(st->error_message, "ERROR ONLY LABEL DECLARED");
-            return;
-        }
-
-        strcpy(st->label, word);
-        get_first_word(line, word);
-
-        line += strlen(word);
-        escape_white_chars((const char**)&line);
-    }
-
-    /*
-     * Set if it's a directive or instruction
-     */
-    set_type_of_input(st, word);
-
-    /*
-     * Remove white characters and handle errors such as missing comma or missing parameter
-     */
-    if(!(st->lineType == directive && st->dir_or_inst.dir.dirType == string))
-        remove_white_char_from_str(st, line);
-
-    get_parameters_by_type(st, line);
-
-    syntax_validation(st);
-}
-
-void reset_syntax_tree(struct syntax_tree *st) {
-    st->label[0] = '\0'; /* Reset the label field */
-    st->error_message[0] = '\0'; /* Reset the error_message field */
-    st->lineType = empty; /* Reset the lineType field */
-    st->dir_or_inst.dir.dirType = non;
-    st->dir_or_inst.inst.opCode = non;
-
-    /*
-     * Reset the additional fields in the sub structs
-     */
-    if (st->lineType == directive) {
-        st->dir_or_inst.dir.dirType = entry;
-        st->dir_or_inst.dir.dir_info.label[0] = '\0';
-        st->dir_or_inst.dir.dir_info.str[0] = '\0';
-        /*
-         * Reset the additional fields in the directive
-         */
-    } else if (st->lineType == instruction) {
-        st->dir_or_inst.inst.opCode = op_code_mov;
-        /*
-         * Reset the additional fields in the instruction
-         */
-    }
-}
-
-void clear_syntax_tree(struct syntax_tree *st){
-    if(st != NULL){
-        reset_syntax_tree(st);
-    }
-}
+/*
+ * The lexer builds the syntax tree of a line in a single left-to-right pass, without heap allocations.
+ * Every character is mapped to a class by a 256-entry table, and two small automata are driven by the classes:
+ * - The operands automaton follows the commas and white characters between the operands.
+ * - The token automaton classifies each operand (number, register, label) while it is read.
+ */
+
+#include <stdlib.h>
+#include "lexer.h"
+#include "string.h"
+#include "parser.h"
+#include "keywords.h"
+#include "isa.h"
+#include "utils.h"
+
+/*
+ * Character classes
+ */
+enum char_class {
+    C_OTHER,
+    C_SPACE,
+    C_COMMA,
+    C_OCTAL,  /* 0-7, a register number */
+    C_DIGIT,  /* 8-9 */
+    C_SIGN,   /* + - */
+    C_AT,     /* @ */
+    C_R,      /* r */
+    C_LETTER  /* A-z, the first letter of a label */
+};
+
+#define AMOUNT_OF_CLASSES 9
+
+static const unsigned char char_classes[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, /* 0x00 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x10 */
+        1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 2, 5, 0, 0, /* 0x20 */
+        3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 0, 0, 0, 0, 0, 0, /* 0x30 */
+        6, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, /* 0x40 */
+        8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, /* 0x50 */
+        8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, /* 0x60 */
+        8, 8, 7, 8, 8, 8, 8, 8, 8, 8, 8, 0, 0, 0, 0, 0, /* 0x70 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x80 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x90 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xA0 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xB0 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xC0 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xD0 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0xE0 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0  /* 0xF0 */
+};
+
+#define CLASS_OF(ch) ((enum char_class) char_classes[(unsigned char) (ch)])
+
+/*
+ * States of the operands automaton.
+ * A white character between two operands without a comma, or two commas without an operand, are errors.
+ */
+enum operands_state {
+    S_BEGIN,
+    S_OPERAND,
+    S_OPERAND_SPACE,
+    S_COMMA,
+    S_MISSING_COMMA,
+    S_TOO_MANY_COMMAS
+};
+
+static const unsigned char operands_transitions[6][AMOUNT_OF_CLASSES] = {
+        /*                 OTHER            SPACE             COMMA              OCTAL            DIGIT            SIGN             AT               R                LETTER */
+        /* BEGIN */       {S_OPERAND,       S_OPERAND_SPACE,  S_COMMA,           S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND},
+        /* OPERAND */     {S_OPERAND,       S_OPERAND_SPACE,  S_COMMA,           S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND},
+        /* SPACE */       {S_MISSING_COMMA, S_OPERAND_SPACE,  S_COMMA,           S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA},
+        /* COMMA */       {S_OPERAND,       S_COMMA,          S_TOO_MANY_COMMAS, S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND,       S_OPERAND},
+        /* MISSING */     {S_MISSING_COMMA, S_MISSING_COMMA,  S_MISSING_COMMA,   S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA, S_MISSING_COMMA},
+        /* TOO MANY */    {S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS, S_TOO_MANY_COMMAS}
+};
+
+/*
+ * States of the token automaton, which classifies a single operand.
+ */
+enum token_state {
+    T_EMPTY,
+    T_SIGN,
+    T_NUMBER,
+    T_AT,
+    T_AT_R,
+    T_REGISTER,
+    T_LABEL,
+    T_INVALID
+};
+
+static const unsigned char token_transitions[8][AMOUNT_OF_CLASSES] = {
+        /*                OTHER      SPACE      COMMA      OCTAL       DIGIT      SIGN       AT         R          LETTER */
+        /* EMPTY */      {T_INVALID, T_INVALID, T_INVALID, T_NUMBER,   T_NUMBER,  T_SIGN,    T_AT,      T_LABEL,   T_LABEL},
+        /* SIGN */       {T_INVALID, T_INVALID, T_INVALID, T_NUMBER,   T_NUMBER,  T_INVALID, T_INVALID, T_INVALID, T_INVALID},
+        /* NUMBER */     {T_INVALID, T_INVALID, T_INVALID, T_NUMBER,   T_NUMBER,  T_INVALID, T_INVALID, T_INVALID, T_INVALID},
+        /* AT */         {T_INVALID, T_INVALID, T_INVALID, T_INVALID,  T_INVALID, T_INVALID, T_INVALID, T_AT_R,    T_INVALID},
+        /* AT_R */       {T_INVALID, T_INVALID, T_INVALID, T_REGISTER, T_INVALID, T_INVALID, T_INVALID, T_INVALID, T_INVALID},
+        /* REGISTER */   {T_INVALID, T_INVALID, T_INVALID, T_INVALID,  T_INVALID, T_INVALID, T_INVALID, T_INVALID, T_INVALID},
+        /* LABEL */      {T_LABEL,   T_INVALID, T_INVALID, T_LABEL,    T_LABEL,   T_LABEL,   T_LABEL,   T_LABEL,   T_LABEL},
+        /* INVALID */    {T_INVALID, T_INVALID, T_INVALID, T_INVALID,  T_INVALID, T_INVALID, T_INVALID, T_INVALID, T_INVALID}
+};
+
+/*
+ * Numbers are saturated at this value while they are read, so a long number is still out of range.
+ */
+#define MAX_NUMBER_VALUE 100000000L
+
+/*
+ * An operand found by the operands automaton.
+ */
+struct operand_token {
+    int start;
+    int length;
+    enum token_state state;
+    long value;
+};
+
+/*
+ * Everything the single pass over the operands finds out.
+ */
+struct operand_tokens {
+    struct operand_token list[MAX_VARS];
+    int count;
+    enum operands_state state;
+    int last_non_space;
+};
+
+/*
+ * Reads the operands part of a line: splits it to operands, classifies them, and follows the commas.
+ */
+static void scan_operands(const char *line, int start, int end, struct operand_tokens *operands) {
+    enum operands_state state = S_BEGIN, next;
+    enum char_class class;
+    struct operand_token *current = NULL;
+    bool is_negative = false;
+    int i = start;
+
+    operands->count = 0;
+    operands->last_non_space = start - 1;
+
+    for (; i < end; ++i) {
+        class = CLASS_OF(line[i]);
+        next = (enum operands_state) operands_transitions[state][class];
+
+        if (class != C_SPACE) {
+            operands->last_non_space = i;
+        }
+
+        if (next == S_OPERAND) {
+            /* A new operand starts */
+            if (state != S_OPERAND) {
+                current = operands->count < MAX_VARS ? &operands->list[operands->count] : NULL;
+                operands->count++;
+                if (current != NULL) {
+                    current->start = i;
+                    current->length = 0;
+                    current->state = T_EMPTY;
+                    current->value = 0;
+                    is_negative = line[i] == '-';
+                }
+            }
+
+            if (current != NULL) {
+                current->state = (enum token_state) token_transitions[current->state][class];
+                current->length++;
+                if (current->state == T_NUMBER && current->value < MAX_NUMBER_VALUE) {
+                    current->value = current->value * 10 + (line[i] - '0');
+                } else if (current->state == T_REGISTER) {
+                    current->value = line[i] - '0';
+                }
+            }
+        } else if (state == S_OPERAND && current != NULL && current->state == T_NUMBER && is_negative) {
+            current->value = -current->value;
+        }
+
+        /* A comma right at the beginning is an empty operand */
+        if (class == C_COMMA && state == S_BEGIN) {
+            if (operands->count < MAX_VARS) {
+                operands->list[operands->count].start = i;
+                operands->list[operands->count].length = 0;
+                operands->list[operands->count].state = T_EMPTY;
+                operands->list[operands->count].value = 0;
+            }
+            operands->count++;
+        }
+
+        state = next;
+    }
+
+    if (state == S_OPERAND && current != NULL && current->state == T_NUMBER && is_negative) {
+        current->value = -current->value;
+    }
+    operands->state = state;
+}
+
+/*
+ * Sets an operand of the syntax tree by the final state of the token automaton.
+ */
+static void set_operand(struct operand *operand, const char *line, const struct operand_token *token,
+                        struct intern_pool *names) {
+    operand->type = invalid_operand;
+    if (token->length > MAX_LABEL_SIZE) {
+        return;
+    }
+    switch (token->state) {
+        case T_NUMBER:
+            operand->type = immediate;
+            operand->data.value = (int) token->value;
+            break;
+        case T_REGISTER:
+            operand->type = direct_register;
+            operand->data.value = (int) token->value;
+            break;
+        case T_LABEL:
+            operand->type = direct;
+            operand->data.symbol_id = intern_name(names, line + token->start, token->length);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Check if the word (input) is a valid label:
+ * - Starts with a letter
+ * - Does not equal a reserved word
+ */
+static bool is_label(struct syntax_tree *st, const char *input, int length){
+    if(find_keyword(input, length) != NULL){
+        SET_ERROR(error_label_reserved_word)
+    } else if(length == 0 || length > MAX_LABEL_SIZE || CLASS_OF(input[0]) < C_R){
+        SET_ERROR(error_label_invalid)
+    }
+    return true;
+}
+
+/*
+ * Extract a string from a sentence.
+ * A string is enclosed in apostrophes.
+ * Example: "string "word""
+ */
+static bool extract_string(struct syntax_tree *st, const char *line, int start, const struct operand_tokens *operands){
+    int length = operands->last_non_space - start + 1;
+
+    if(length <= 0){
+        SET_ERROR(error_missing_string)
+    }
+    if(line[start] != '\"'){
+        SET_ERROR(error_string_not_open)
+    }
+    if(line[operands->last_non_space] != '\"'){
+        SET_ERROR(error_string_not_closed)
+    }
+
+    /*
+     * Remove the quotes from the string
+     */
+    st->dir_or_inst.dir.dir_info.str.start = line + start + 1;
+    st->dir_or_inst.dir.dir_info.str.length = length >= 2 ? length - 2 : 0;
+
+    return true;
+}
+
+/*
+ * Extract a list of integers to an array.
+ * The result is stored in st->dir_or_inst->dir->dir_info->num_arr->int_arr.
+ * Example of a list of integers: "1,2,3,4,5,6,7"
+ */
+static bool extract_ints(struct syntax_tree *st, const struct operand_tokens *operands){
+    int i = 0, num;
+
+    if(operands->count == 0){
+        SET_ERROR(error_not_enough_variables)
+    }
+
+    for (; i < MAX_VARS && i < operands->count; ++i) {
+        if(operands->list[i].state != T_NUMBER){
+            SET_ERROR(error_not_a_number)
+        }
+
+        num = (int) operands->list[i].value;
+        if(operands->list[i].value < -2048 || operands->list[i].value > 2047) {
+            st->lineType = error;
+            st->error = error_number_out_of_range;
+            num = -1;
+        }
+
+        st->dir_or_inst.dir.dir_info.num_arr.int_arr[i] = (short) num;
+        st->dir_or_inst.dir.dir_info.num_arr.arr_length = i + 1;
+    }
+
+    return true;
+}
+
+/*
+ * Extract the amount of words to reserve to st->dir_or_inst->dir->dir_info->space_length.
+ * The amount is a single positive number, at most the size of the memory.
+ * Example of parameter: "100"
+ */
+static bool extract_space_length(struct syntax_tree *st, const struct operand_tokens *operands){
+    if(operands->count == 0){
+        SET_ERROR(error_not_enough_variables)
+    }
+    if(operands->count > 1){
+        SET_ERROR(error_too_many_variables)
+    }
+    if(operands->list[0].state != T_NUMBER){
+        SET_ERROR(error_not_a_number)
+    }
+    if(operands->list[0].value < 1 || operands->list[0].value > MAX_MEMORY_SIZE){
+        SET_ERROR(error_number_out_of_range)
+    }
+
+    st->dir_or_inst.dir.dir_info.space_length = (int) operands->list[0].value;
+    return true;
+}
+
+/*
+ * Extract the source and destination operands to st->dir_or_inst->inst->src and st->dir_or_inst->inst->des.
+ * Example of two parameters: "src,des"
+ */
+static bool extract_two_parameters(struct syntax_tree *st, const char *line, const struct operand_tokens *operands,
+                                   struct intern_pool *names) {
+    if (operands->count == 0 || operands->list[0].length == 0) {
+        SET_ERROR(error_missing_parameter)
+    }
+    if (operands->count > 2) {
+        SET_ERROR(error_too_many_variables)
+    }
+
+    set_operand(&st->dir_or_inst.inst.src, line, &operands->list[0], names);
+
+    if (operands->count < 2) {
+        SET_ERROR(error_missing_parameter)
+    }
+
+    set_operand(&st->dir_or_inst.inst.des, line, &operands->list[1], names);
+
+    return true;
+}
+
+/*
+ * Extract the destination operand to st->dir_or_inst->inst->des.
+ * Example of parameter: "des"
+ */
+static bool extract_single_parameter(struct syntax_tree *st, const char *line, const struct operand_tokens *operands,
+                                     struct intern_pool *names){
+    if(operands->count > 1){
+        SET_ERROR(error_too_many_variables)
+    } else if(operands->count == 0) {
+        SET_ERROR(error_missing_variable)
+    }
+
+    set_operand(&st->dir_or_inst.inst.des, line, &operands->list[0], names);
+
+    return true;
+}
+
+/*
+ * Extract a label to st->dir_or_inst->dir->dir_info->label_id.
+ * Example of parameter: "label"
+ */
+static bool extract_single_label(struct syntax_tree *st, const char *line, const struct operand_tokens *operands,
+                                 struct intern_pool *names){
+    if(operands->count > 1){
+        SET_ERROR(error_too_many_parameters)
+    }
+    if(operands->count == 0){
+        SET_ERROR(error_missing_label)
+    }
+    if(!is_label(st, line + operands->list[0].start, operands->list[0].length)){
+        SET_ERROR(error_not_a_valid_label)
+    }
+
+    st->dir_or_inst.dir.dir_info.label_id = intern_name(names, line + operands->list[0].start, operands->list[0].length);
+    return true;
+}
+
+/*
+ * The function navigates the syntax tree and calls the correct extracting function based on the type of input.
+ */
+static bool get_parameters_by_type(struct syntax_tree *st, const char *line, int start,
+                                   const struct operand_tokens *operands, struct intern_pool *names) {
+    if(st->lineType == directive){
+        if(st->dir_or_inst.dir.dirType == string){
+            extract_string(st, line, start, operands);
+        } else if(st->dir_or_inst.dir.dirType == data){
+            extract_ints(st, operands);
+        } else if(st->dir_or_inst.dir.dirType == space){
+            extract_space_length(st, operands);
+        } else if(st->dir_or_inst.dir.dirType == entry ||
+                  st->dir_or_inst.dir.dirType == external){
+            extract_single_label(st, line, operands, names);
+        }
+    } else if (st->lineType == instruction){
+        switch (get_instruction_info(st->dir_or_inst.inst.opCode)->operands_count) {
+            case 2:
+                extract_two_parameters(st, line, operands, names);
+                break;
+            case 1:
+                extract_single_parameter(st, line, operands, names);
+                break;
+            default:
+                if(operands->last_non_space >= start){
+                    SET_ERROR(error_too_many_parameters)
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Classify the syntax tree line type:
+ * - directive: starts with a dot, optional inputs - ".string", ".data", ".space", ".entry", ".extern"
+ * - instruction: "mov", "cmp", "add", "sub", "not", "clr", "lea", "inc", "dec", "jmp", "bne", "red", "prn", "jsr", "rts", "stop"
+ * - comment: starts with ';', e.g., ";comment line"
+ */
+static void set_type_of_input(struct syntax_tree *st, const char *input, int length){
+    const struct keyword *keyword = find_keyword(input, length);
+
+    if(length > 0 && input[0] == '.'){
+        st->lineType = directive;
+        st->dir_or_inst.dir.dirType = -1;
+
+        if(keyword == NULL || keyword->type != keyword_directive){
+            SET_ERROR_NO_RETURN(error_invalid_declaration)
+            return;
+        }
+        st->dir_or_inst.dir.dirType = keyword->value;
+
+    } else if(length > 0 && input[0] == ';') {
+        st->lineType = comment;
+    } else{
+        st->lineType = instruction;
+
+        if(keyword == NULL || keyword->type != keyword_instruction){
+            SET_ERROR_NO_RETURN(error_unrecognized_command)
+            return;
+        }
+        st->dir_or_inst.inst.opCode = keyword->value;
+    }
+}
+
+/*
+ * Returns the index of the first white character (or the end) from the index i.
+ */
+static int skip_word(const char *line, int i, int length){
+    while (i < length && CLASS_OF(line[i]) != C_SPACE) {
+        i++;
+    }
+    return i;
+}
+
+/*
+ * Returns the index of the first non-white character (or the end) from the index i.
+ */
+static int skip_white_chars(const char *line, int i, int length){
+    while (i < length && CLASS_OF(line[i]) == C_SPACE) {
+        i++;
+    }
+    return i;
+}
+
+/*
+ * Initialize all the fields of the syntax tree based on the input (line).
+ * Set the declaration label, type of the command line (directive or instruction), and the variables of the current command.
+ * The line isn't changed, and doesn't have to be null terminated.
+ * The labels are added to the intern pool (names), and the syntax tree holds their ids.
+ */
+void build_syntax_tree_from_line(struct syntax_tree *st, const char *line, int length, struct intern_pool *names){
+    struct operand_tokens operands;
+    int word_start, word_end, label_start;
+
+    clear_syntax_tree(st);
+
+    st->label_id = -1;
+    st->lineType = 0;
+    st->operands_index = length;
+    st->is_operands_compacted = false;
+    if(length > 0 && line[length - 1] == '\n'){
+        length--;
+    }
+
+    /*
+     * Check if the sentence starts with a label
+     */
+    word_start = skip_white_chars(line, 0, length);
+    word_end = skip_word(line, word_start, length);
+
+    if(word_end > word_start && line[word_end - 1] == ':'){
+        label_start = word_start;
+        if(!is_label(st, line + word_start, word_end - word_start - 1)){
+            return;
+        }
+
+        word_start = skip_white_chars(line, word_end, length);
+        if(word_start == length) {
+            st->lineType = error;
+            st->error = error_only_label;
+            return;
+        }
+
+        st->label_id = intern_name(names, line + label_start, word_end - label_start - 1);
+
+        word_end = skip_word(line, word_start, length);
+    }
+
+    /*
+     * Set if it's a directive or instruction
+     */
+    set_type_of_input(st, line + word_start, word_end - word_start);
+
+    /*
+     * Read the operands: split them, classify them, and find errors such as missing comma or missing parameter
+     */
+    st->operands_index = skip_white_chars(line, word_end, length);
+    scan_operands(line, st->operands_index, length, &operands);
+
+    if(!(st->lineType == directive && st->dir_or_inst.dir.dirType == string)){
+        if(operands.state == S_MISSING_COMMA){
+            SET_ERROR_NO_RETURN(error_missing_comma)
+        } else if(operands.state == S_TOO_MANY_COMMAS){
+            SET_ERROR_NO_RETURN(error_too_many_commas)
+        } else if(operands.state == S_COMMA){
+            SET_ERROR_NO_RETURN(error_trailing_comma)
+        } else {
+            st->is_operands_compacted = true;
+        }
+    }
+
+    get_parameters_by_type(st, line, st->operands_index, &operands, names);
+
+    syntax_validation(st);
+}
+
+/*
+ * Writes the line as it is printed in an error message: without the '\n',
+ * and without the white characters between the operands when they were read successfully.
+ */
+void get_printable_line(const struct syntax_tree *st, const char *line, int length, char *dest){
+    int i = 0, j = 0;
+
+    if(length > 0 && line[length - 1] == '\n'){
+        length--;
+    }
+
+    for (; i < length; ++i) {
+        if(!st->is_operands_compacted || i < st->operands_index || CLASS_OF(line[i]) != C_SPACE){
+            dest[j++] = line[i];
+        }
+    }
+    dest[j] = '\0';
+}
+
+void reset_syntax_tree(struct syntax_tree *st) {
+    st->label_id = -1; /* Reset the label field */
+    st->error = no_error; /* Reset the error field */
+    st->lineType = empty; /* Reset the lineType field */
+    st->dir_or_inst.dir.dirType = non;
+    st->dir_or_inst.inst.opCode = non;
+    st->dir_or_inst.inst.src.type = no_operand;
+    st->dir_or_inst.inst.des.type = no_operand;
+}
+
+void clear_syntax_tree(struct syntax_tree *st){
+    if(st != NULL){
+        reset_syntax_tree(st);
+    }
+}
+
+/*
+ * The message of each error code, in the order of enum error_code.
+ */
+static const char *error_messages[] = {
+        "",
+        "ERROR LABEL IS INVALID, RESERVED WORD USED",
+        "ERROR LABEL IS INVALID",
+        "ERROR ONLY LABEL DECLARED",
+        "ERROR INVALID DECLARATION",
+        "ERROR UNRECOGNIZED COMMAND",
+        "ERROR MISSING COMMA",
+        "ERROR TOO MANY COMMAS OR MISSING PARAMETER",
+        "ERROR MISSING PARAMETER OR TOO MANY COMMAS",
+        "ERROR MISSING STRING",
+        "ERROR STRING NOT OPEN",
+        "ERROR STRING NOT CLOSED",
+        "ERROR NOT ENOUGH VARIABLES",
+        "ERROR INPUT ISN'T A NUMBER OR INPUT IS EMPTY",
+        "ERROR NUMBER OUT OF RANGE",
+        "ERROR MISSING PARAMETER",
+        "ERROR TOO MANY VARIABLES",
+        "ERROR MISSING VARIABLE",
+        "ERROR TOO MANY PARAMETERS",
+        "ERROR MISSING LABEL",
+        "ERROR NOT A VALID LABEL",
+        "ERROR INVALID SOURCE OPERAND",
+        "ERROR INVALID DESTINATION OPERAND"
+};
+
+const char *get_error_message(enum error_code code){
+    return error_messages[code];
+}
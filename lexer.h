@@ -1,90 +1,154 @@
-#ifndef ASSEMBLER_LEXER_H
-#define ASSEMBLER_LEXER_H
-
-#include "utils.h"
-
-#define SET_ERROR(error_msg) { st->lineType = error; strcpy(st->error_message, error_msg); return false;}
-
-
-enum line_type{
-    error = -1,
-    empty,
-    comment,
-    directive,
-    instruction
-};
-
-enum dir_type{
-    non,
-    entry,
-    external,
-    string,
-    data
-};
-
-enum op_code {
-    op_code_mov = 1,
-    op_code_cmp,
-    op_code_add,
-    op_code_sub,
-    op_code_not,
-    op_code_clr,
-    op_code_lea,
-    op_code_inc,
-    op_code_dec,
-    op_code_jmp,
-    op_code_bne,
-    op_code_red,
-    op_code_prn,
-    op_code_jsr,
-    op_code_rts,
-    op_code_stop
-};
-
-
-struct syntax_tree{
-    char label[MAX_LABEL_SIZE + 1];
-    char error_message[MAX_ERROR_MSG_SIZE + 1];
-
-    enum line_type lineType;
-
-    union {
-        struct {
-            enum dir_type dirType;
-            union {
-                char label[MAX_LABEL_SIZE + 1];
-                char str[MAX_LINE_SIZE + 1];
-                struct {
-                    int int_arr[MAX_VARS];
-                    int arr_length;
-                }num_arr;
-            }dir_info;
-
-        }dir;
-
-        struct {
-            enum op_code opCode;
-
-            union {
-                struct {
-                    char parameter[MAX_LABEL_SIZE + 1];
-                }one_parameter;
-
-                struct {
-                    char des_parameter[MAX_LABEL_SIZE + 1];
-                    char src_parameter[MAX_LABEL_SIZE + 1];
-                }two_parameters;
-            }one_or_two_parameters;
-
-        }inst;
-
-
-    }dir_or_inst;
-
-
-};
-
-void build_syntax_tree_from_line(struct syntax_tree *st, char *line);
-void clear_syntax_tree(struct syntax_tree *st);
-
-#endif
+#ifndef ASSEMBLER_LEXER_H
+#define ASSEMBLER_LEXER_H
+
+#include "utils.h"
+#include "intern_pool.h"
+
+#define SET_ERROR(code) { st->lineType = error; st->error = code; return false;}
+#define SET_ERROR_NO_RETURN(code) { st->lineType = error; st->error = code;}
+
+
+enum line_type{
+    error = -1,
+    empty,
+    comment,
+    directive,
+    instruction
+};
+
+enum dir_type{
+    non,
+    entry,
+    external,
+    string,
+    data,
+    space
+};
+
+enum op_code {
+    op_code_mov = 1,
+    op_code_cmp,
+    op_code_add,
+    op_code_sub,
+    op_code_not,
+    op_code_clr,
+    op_code_lea,
+    op_code_inc,
+    op_code_dec,
+    op_code_jmp,
+    op_code_bne,
+    op_code_red,
+    op_code_prn,
+    op_code_jsr,
+    op_code_rts,
+    op_code_stop
+};
+
+/*
+ * The addressing method of an operand, found by the lexer while the operand is read.
+ */
+enum operand_type {
+    invalid_operand = -1,
+    no_operand,
+    immediate = 1,
+    direct = 3,
+    direct_register = 5
+};
+
+/*
+ * The errors the lexer and the parser find in a line, the message of each error is returned by get_error_message.
+ */
+enum error_code {
+    no_error,
+    error_label_reserved_word,
+    error_label_invalid,
+    error_only_label,
+    error_invalid_declaration,
+    error_unrecognized_command,
+    error_missing_comma,
+    error_too_many_commas,
+    error_trailing_comma,
+    error_missing_string,
+    error_string_not_open,
+    error_string_not_closed,
+    error_not_enough_variables,
+    error_not_a_number,
+    error_number_out_of_range,
+    error_missing_parameter,
+    error_too_many_variables,
+    error_missing_variable,
+    error_too_many_parameters,
+    error_missing_label,
+    error_not_a_valid_label,
+    error_invalid_source_operand,
+    error_invalid_destination_operand
+};
+
+/*
+ * A part of the source: the text isn't copied, and isn't null terminated.
+ */
+struct string_view {
+    const char *start;
+    int length;
+};
+
+/*
+ * An operand of an instruction: its addressing method, and the number (immediate or register) or the id of the label it holds.
+ */
+struct operand {
+    enum operand_type type;
+    union {
+        int value;
+        int symbol_id;
+    }data;
+};
+
+/*
+ * The syntax tree of a line.
+ * Labels are kept as their ids in the intern pool, and the string of .string is a view of the line,
+ * so the line must be kept as long as the syntax tree is used.
+ */
+struct syntax_tree{
+    int label_id;
+    enum line_type lineType;
+    enum error_code error;
+
+    /*
+     * Where the operands start in the line, and if the white characters between them are dropped when the line is printed
+     */
+    int operands_index;
+    bool is_operands_compacted;
+
+    union {
+        struct {
+            enum dir_type dirType;
+            union {
+                int label_id;
+                int space_length;
+                struct string_view str;
+                struct {
+                    short int_arr[MAX_VARS];
+                    int arr_length;
+                }num_arr;
+            }dir_info;
+
+        }dir;
+
+        struct {
+            enum op_code opCode;
+            struct operand src;
+            struct operand des;
+        }inst;
+
+
+    }dir_or_inst;
+
+
+};
+
+void build_syntax_tree_from_line(struct syntax_tree *st, const char *line, int length, struct intern_pool *names);
+void get_printable_line(const struct syntax_tree *st, const char *line, int length, char *dest);
+void clear_syntax_tree(struct syntax_tree *st);
+const char *get_error_message(enum error_code code);
+
+#endif
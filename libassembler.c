@@ -0,0 +1,216 @@
+/*
+ * Assembles a source in memory, see libassembler.h. The passes are the same as the command line's,
+ * the errors are kept as records instead of being printed, and the result is copied out of the tables of the passes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libassembler.h"
+#include "am_builder.h"
+#include "source_reader.h"
+#include "symbol_table.h"
+#include "coded_list.h"
+#include "first_pass.h"
+#include "second_pass.h"
+
+/*
+ * Function: allocate
+ * ------------------
+ * Allocates memory for the result, the program stops if it can't.
+ *
+ * size: The size of the memory.
+ *
+ * returns: The memory, NULL if size is 0.
+ */
+static void *allocate(size_t size) {
+    void *memory;
+
+    if (size == 0) {
+        return NULL;
+    }
+
+    memory = malloc(size);
+    if (memory == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+    return memory;
+}
+
+/*
+ * Function: copy_words
+ * --------------------
+ * Copies the words of a coded list, the runs are expanded.
+ *
+ * dest: The place of the first word.
+ * list: The coded list.
+ */
+static void copy_words(uint16_t *dest, const struct coded_list *list) {
+    struct word_cursor words;
+    unsigned int word;
+    int count;
+
+    init_word_cursor(&words, list);
+    while ((count = next_words(&words, &word)) > 0) {
+        for (; count > 0; --count) {
+            *dest++ = (uint16_t) word;
+        }
+    }
+}
+
+/*
+ * Function: add_result_symbol
+ * ---------------------------
+ * Adds a symbol to the entries or the externs of the result, its name is copied to the names of the result.
+ *
+ * symbol: The place of the symbol.
+ * names: The place of the name in the names of the result, moved after it.
+ * name: The name.
+ * address: The address.
+ */
+static void add_result_symbol(struct assembler_symbol *symbol, char **names, const char *name, int address) {
+    size_t length = strlen(name) + 1;
+
+    memcpy(*names, name, length);
+    symbol->name = *names;
+    symbol->address = address;
+    *names += length;
+}
+
+/*
+ * Function: copy_result
+ * ---------------------
+ * Copies the words, the entries and the externs of an assembly without errors to its result.
+ *
+ * result: The result.
+ * symbols: The symbol table, resolved.
+ * inst_coded_list: The coded instructions, patched.
+ * dir_coded_list: The coded directives.
+ */
+static void copy_result(struct assembler_result *result, const struct symbol_table *symbols,
+                        const struct coded_list *inst_coded_list, const struct coded_list *dir_coded_list) {
+    const struct fixup *fixup;
+    size_t names_size = 0;
+    char *names;
+    int i;
+
+    for (i = 0; i < symbols->symbols_count; ++i) {
+        if (symbols->symbols[i].is_entry) {
+            result->entries_count++;
+            names_size += strlen(get_interned_name(symbols->names, i)) + 1;
+        }
+    }
+    for (i = 0; i < inst_coded_list->fixups_count; ++i) {
+        if (inst_coded_list->fixups[i].kind == are_external) {
+            result->externs_count++;
+            names_size += strlen(get_interned_name(symbols->names, inst_coded_list->fixups[i].symbol_id)) + 1;
+        }
+    }
+
+    result->inst_length = inst_coded_list->length;
+    result->dir_length = dir_coded_list->length;
+    result->words = (uint16_t *) allocate((result->inst_length + result->dir_length) * sizeof(uint16_t));
+    copy_words(result->words, inst_coded_list);
+    copy_words(result->words + result->inst_length, dir_coded_list);
+
+    result->entries = (struct assembler_symbol *) allocate(result->entries_count * sizeof(struct assembler_symbol));
+    result->externs = (struct assembler_symbol *) allocate(result->externs_count * sizeof(struct assembler_symbol));
+    result->names = names = (char *) allocate(names_size);
+
+    result->entries_count = 0;
+    for (i = 0; i < symbols->symbols_count; ++i) {
+        if (symbols->symbols[i].is_entry) {
+            add_result_symbol(&result->entries[result->entries_count++], &names, get_interned_name(symbols->names, i),
+                              symbols->symbols[i].labels_index);
+        }
+    }
+
+    result->externs_count = 0;
+    for (i = 0; i < inst_coded_list->fixups_count; ++i) {
+        fixup = &inst_coded_list->fixups[i];
+        if (fixup->kind == are_external) {
+            add_result_symbol(&result->externs[result->externs_count++], &names,
+                              get_interned_name(symbols->names, fixup->symbol_id), BASE_ADDRESS + fixup->offset);
+        }
+    }
+}
+
+/*
+ * Function: assemble_buffer
+ * -------------------------
+ * Assembles a source in memory: its macros are expanded, it is coded and its labels are resolved,
+ * as the command line does for a file. Nothing is read or written but the buffers, and all the state
+ * of the assembly belongs to the call, so it can be called on any amount of threads at once.
+ *
+ * source: The content of the source (the .as file), it isn't changed.
+ * size: The size of the content.
+ * settings: How the source is assembled, NULL for the defaults.
+ * result: The result, to be freed with free_assembler_result.
+ *
+ * returns: True if there are no errors.
+ */
+bool assemble_buffer(const char *source, long size, const struct assembler_settings *settings,
+                     struct assembler_result *result) {
+    static const struct assembler_settings default_settings = DEFAULT_ASSEMBLER_SETTINGS;
+    struct source_file source_file;
+    struct am_source am = EMPTY_AM_SOURCE;
+    struct intern_pool names;
+    struct diagnostics diagnostics;
+    struct symbol_table symbols;
+    struct coded_list inst_coded_list;
+    struct coded_list dir_coded_list;
+
+    if (settings == NULL) {
+        settings = &default_settings;
+    }
+    memset(result, 0, sizeof(struct assembler_result));
+
+    init_diagnostics(&diagnostics, NULL, true);
+    init_intern_pool(&names);
+    open_source_buffer(&source_file, source, size);
+    am_builder(&source_file, &am, &names, &diagnostics);
+    close_source_file(&source_file);
+
+    init_symbol_table(&symbols, &names, &diagnostics);
+    init_coded_list(&inst_coded_list);
+    init_coded_list(&dir_coded_list);
+
+    first_pass(&am, &names, &symbols, &inst_coded_list, &dir_coded_list, &result->errors_count, settings->one_pass,
+               settings->threads_count, settings->lex_ahead, &diagnostics);
+
+    if (result->errors_count == 0) {
+        patch_fixups(&symbols, &inst_coded_list);
+        copy_result(result, &symbols, &inst_coded_list, &dir_coded_list);
+    }
+
+    /*
+     * The records are handed to the result as they are
+     */
+    result->diagnostics = diagnostics.records;
+    result->diagnostics_count = diagnostics.records_count;
+
+    free_coded_list(&inst_coded_list);
+    free_coded_list(&dir_coded_list);
+    free_symbol_table(&symbols);
+    free_intern_pool(&names);
+    free_am_source(&am);
+
+    return result->errors_count == 0;
+}
+
+/*
+ * Function: free_assembler_result
+ * -------------------------------
+ * Frees the memory of a result.
+ *
+ * result: The result.
+ */
+void free_assembler_result(struct assembler_result *result) {
+    free(result->words);
+    free(result->entries);
+    free(result->externs);
+    free(result->names);
+    free(result->diagnostics);
+    memset(result, 0, sizeof(struct assembler_result));
+}
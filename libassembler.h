@@ -0,0 +1,59 @@
+#ifndef ASSEMBLER_LIBASSEMBLER_H
+#define ASSEMBLER_LIBASSEMBLER_H
+
+#include <stdint.h>
+#include "utils.h"
+#include "diagnostics.h"
+
+/*
+ * The library API of the assembler: a source in memory is assembled to a result in memory, without files
+ * and without shared state, so any amount of sources can be assembled at once on different threads.
+ */
+
+/*
+ * How a source is assembled, as the options of the command line: one_pass backpatches the words that use labels
+ * during the first pass, threads_count is the amount of workers the lines can be coded on,
+ * and lex_ahead runs the lexer on a thread of its own.
+ */
+struct assembler_settings {
+    bool one_pass;
+    bool lex_ahead;
+    int threads_count;
+};
+
+#define DEFAULT_ASSEMBLER_SETTINGS {false, false, 1}
+
+/*
+ * A label and an address: an entry and its address, or an external label and the address of a word that uses it.
+ */
+struct assembler_symbol {
+    const char *name;
+    int address;
+};
+
+/*
+ * The result of an assembly. words is the memory from BASE_ADDRESS: the inst_length words of the instructions
+ * and then the dir_length words of the directives, as in the .obj file. entries and externs are the lines
+ * of the .ent and .ext files, their names are kept in names. diagnostics are the errors in the order
+ * the command line prints them, errors_count is the amount of errors the command line counts
+ * (the errors of the macros aren't counted). When there are errors, there are no words, entries or externs.
+ */
+struct assembler_result {
+    uint16_t *words;
+    int inst_length;
+    int dir_length;
+    struct assembler_symbol *entries;
+    int entries_count;
+    struct assembler_symbol *externs;
+    int externs_count;
+    char *names;
+    struct diagnostic *diagnostics;
+    int diagnostics_count;
+    int errors_count;
+};
+
+bool assemble_buffer(const char *source, long size, const struct assembler_settings *settings,
+                     struct assembler_result *result);
+void free_assembler_result(struct assembler_result *result);
+
+#endif
@@ -0,0 +1,540 @@
+/*
+ * The encodings of the object. Every format is an emitter with its own buffered output file,
+ * and the resolved words are streamed to all the requested emitters in a single traversal.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "object_formats.h"
+
+#define OUTPUT_BUFFER_SIZE 4096
+#define RECORD_SIZE 16
+
+struct emitter_output;
+
+/*
+ * An emitter: the ending of its output and its callbacks. begin is called before the words,
+ * word once for every word in the order of the addresses, and end after the last word.
+ * run is called for a run of the same word (reserved by .space), an emitter without it gets the run word by word.
+ */
+struct emitter {
+    const char *ending;
+    void (*begin)(struct emitter_output *output, int inst_length, int dir_length, const char *file_name);
+    void (*word)(struct emitter_output *output, int address, unsigned int word);
+    void (*run)(struct emitter_output *output, int address, unsigned int word, int count);
+    void (*end)(struct emitter_output *output);
+};
+
+/*
+ * The output of an emitter: its stream and buffer, the data record that is being filled (for the record formats),
+ * and the run of the same word that is being counted (for the run-length format).
+ */
+struct emitter_output {
+    const struct emitter *emitter;
+    FILE *file;
+    char buffer[OUTPUT_BUFFER_SIZE];
+    int length;
+    unsigned char record[RECORD_SIZE];
+    int record_length;
+    int record_address;
+    int records_count;
+    unsigned int run_word;
+    int run_count;
+};
+
+/*
+ * The base 64 characters of a 12-bit word (half of the full 24-bit block of Base64 encoding),
+ * built at compile time for all the 4096 words.
+ */
+#define BASE64_CHAR(n) ((char) ((n) < 26 ? 'A' + (n) : (n) < 52 ? 'a' + (n) - 26 : \
+        (n) < 62 ? '0' + (n) - 52 : (n) == 62 ? '+' : '/'))
+#define BASE64_PAIR(word) {BASE64_CHAR((word) >> 6), BASE64_CHAR((word) & 0x3F)}
+#define BASE64_PAIRS4(word) BASE64_PAIR(word), BASE64_PAIR((word) + 1), BASE64_PAIR((word) + 2), \
+        BASE64_PAIR((word) + 3)
+#define BASE64_PAIRS16(word) BASE64_PAIRS4(word), BASE64_PAIRS4((word) + 4), BASE64_PAIRS4((word) + 8), \
+        BASE64_PAIRS4((word) + 12)
+#define BASE64_PAIRS64(word) BASE64_PAIRS16(word), BASE64_PAIRS16((word) + 16), BASE64_PAIRS16((word) + 32), \
+        BASE64_PAIRS16((word) + 48)
+#define BASE64_PAIRS256(word) BASE64_PAIRS64(word), BASE64_PAIRS64((word) + 64), BASE64_PAIRS64((word) + 128), \
+        BASE64_PAIRS64((word) + 192)
+#define BASE64_PAIRS1024(word) BASE64_PAIRS256(word), BASE64_PAIRS256((word) + 256), \
+        BASE64_PAIRS256((word) + 512), BASE64_PAIRS256((word) + 768)
+
+static const char base64_pairs[WORD_MASK + 1][2] = {
+        BASE64_PAIRS1024(0), BASE64_PAIRS1024(1024), BASE64_PAIRS1024(2048), BASE64_PAIRS1024(3072)
+};
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+/*
+ * Function: flush_output
+ * ----------------------
+ * Writes the buffer of an output to its file.
+ *
+ * output: The output.
+ */
+static void flush_output(struct emitter_output *output) {
+    fwrite(output->buffer, 1, output->length, output->file);
+    output->length = 0;
+}
+
+/*
+ * Function: write_output
+ * ----------------------
+ * Adds characters to the buffer of an output, the buffer is written to the file when it is full.
+ *
+ * output: The output.
+ * str: The characters, at most OUTPUT_BUFFER_SIZE.
+ * length: The amount of characters.
+ */
+static void write_output(struct emitter_output *output, const char *str, int length) {
+    if (output->length + length > OUTPUT_BUFFER_SIZE) {
+        flush_output(output);
+    }
+    memcpy(output->buffer + output->length, str, length);
+    output->length += length;
+}
+
+/*
+ * Function: write_counts_header
+ * -----------------------------
+ * Writes the header line of the text formats: the amount of instruction words and of directive words.
+ */
+static void write_counts_header(struct emitter_output *output, int inst_length, int dir_length,
+                                const char *file_name) {
+    char line[32];
+
+    write_output(output, line, sprintf(line, "%d %d\n", inst_length, dir_length));
+}
+
+/*
+ * Function: write_base64_word
+ * ---------------------------
+ * Writes a word as a line of two base 64 characters.
+ */
+static void write_base64_word(struct emitter_output *output, int address, unsigned int word) {
+    char line[3];
+
+    line[0] = base64_pairs[word][0];
+    line[1] = base64_pairs[word][1];
+    line[2] = '\n';
+    write_output(output, line, 3);
+}
+
+/*
+ * Function: write_base16_word
+ * ---------------------------
+ * Writes a word as a line of three hexadecimal digits.
+ */
+static void write_base16_word(struct emitter_output *output, int address, unsigned int word) {
+    char line[4];
+
+    line[0] = hex_digits[(word >> 8) & 0xF];
+    line[1] = hex_digits[(word >> 4) & 0xF];
+    line[2] = hex_digits[word & 0xF];
+    line[3] = '\n';
+    write_output(output, line, 4);
+}
+
+/*
+ * Function: write_bin_word
+ * ------------------------
+ * Writes a word as two bytes, little-endian.
+ */
+static void write_bin_word(struct emitter_output *output, int address, unsigned int word) {
+    char bytes[2];
+
+    bytes[0] = (char) (word & 0xFF);
+    bytes[1] = (char) (word >> 8);
+    write_output(output, bytes, 2);
+}
+
+/*
+ * Function: hex_byte
+ * ------------------
+ * Writes a byte as two hexadecimal digits.
+ *
+ * dest: Where to write the digits.
+ * byte: The byte.
+ *
+ * returns: The amount of characters written (2).
+ */
+static int hex_byte(char *dest, unsigned int byte) {
+    dest[0] = hex_digits[(byte >> 4) & 0xF];
+    dest[1] = hex_digits[byte & 0xF];
+    return 2;
+}
+
+/*
+ * Function: write_ihex_record
+ * ---------------------------
+ * Writes an Intel HEX record: its length, address, type, data and checksum (the two's complement of the sum of the bytes).
+ *
+ * output: The output.
+ * type: The type of the record (0 for data, 1 for the end of the file).
+ * address: The byte address of the data.
+ * data: The data of the record.
+ * length: The amount of bytes of data.
+ */
+static void write_ihex_record(struct emitter_output *output, int type, int address, const unsigned char *data,
+                              int length) {
+    char line[64];
+    unsigned int sum = length + (address >> 8) + (address & 0xFF) + type;
+    int i = 0, line_length = 1;
+
+    line[0] = ':';
+    line_length += hex_byte(line + line_length, length);
+    line_length += hex_byte(line + line_length, address >> 8);
+    line_length += hex_byte(line + line_length, address & 0xFF);
+    line_length += hex_byte(line + line_length, type);
+    for (; i < length; ++i) {
+        line_length += hex_byte(line + line_length, data[i]);
+        sum += data[i];
+    }
+    line_length += hex_byte(line + line_length, (0x100 - (sum & 0xFF)) & 0xFF);
+    line[line_length++] = '\n';
+
+    write_output(output, line, line_length);
+}
+
+/*
+ * Function: write_srec_record
+ * ---------------------------
+ * Writes a Motorola S-record with a 16-bit address: its type, count (of the address, data and checksum bytes),
+ * address, data and checksum (the ones' complement of the sum of the bytes).
+ *
+ * output: The output.
+ * type: The type digit of the record ('0' header, '1' data, '5' count, '9' start address).
+ * address: The address field of the record.
+ * data: The data of the record.
+ * length: The amount of bytes of data.
+ */
+static void write_srec_record(struct emitter_output *output, char type, int address, const unsigned char *data,
+                              int length) {
+    char line[64];
+    unsigned int sum = (length + 3) + (address >> 8) + (address & 0xFF);
+    int i = 0, line_length = 2;
+
+    line[0] = 'S';
+    line[1] = type;
+    line_length += hex_byte(line + line_length, length + 3);
+    line_length += hex_byte(line + line_length, address >> 8);
+    line_length += hex_byte(line + line_length, address & 0xFF);
+    for (; i < length; ++i) {
+        line_length += hex_byte(line + line_length, data[i]);
+        sum += data[i];
+    }
+    line_length += hex_byte(line + line_length, ~sum & 0xFF);
+    line[line_length++] = '\n';
+
+    write_output(output, line, line_length);
+}
+
+/*
+ * Function: flush_ihex_record
+ * ---------------------------
+ * Writes the data record that is being filled, if it isn't empty.
+ */
+static void flush_ihex_record(struct emitter_output *output) {
+    if (output->record_length > 0) {
+        write_ihex_record(output, 0, output->record_address, output->record, output->record_length);
+        output->record_length = 0;
+        output->records_count++;
+    }
+}
+
+/*
+ * Function: flush_srec_record
+ * ---------------------------
+ * Writes the data record that is being filled, if it isn't empty.
+ */
+static void flush_srec_record(struct emitter_output *output) {
+    if (output->record_length > 0) {
+        write_srec_record(output, '1', output->record_address, output->record, output->record_length);
+        output->record_length = 0;
+        output->records_count++;
+    }
+}
+
+/*
+ * Function: add_to_record
+ * -----------------------
+ * Adds a word to the data record that is being filled, as two bytes (little-endian) at the byte address of the word.
+ * A full record is written first.
+ *
+ * output: The output.
+ * address: The address of the word.
+ * word: The word.
+ * flush_record: Writes the record in the format of the output.
+ */
+static void add_to_record(struct emitter_output *output, int address, unsigned int word,
+                          void (*flush_record)(struct emitter_output *)) {
+    if (output->record_length == RECORD_SIZE) {
+        flush_record(output);
+    }
+    if (output->record_length == 0) {
+        output->record_address = 2 * address;
+    }
+
+    output->record[output->record_length++] = (unsigned char) (word & 0xFF);
+    output->record[output->record_length++] = (unsigned char) (word >> 8);
+}
+
+static void write_ihex_word(struct emitter_output *output, int address, unsigned int word) {
+    add_to_record(output, address, word, flush_ihex_record);
+}
+
+static void write_srec_word(struct emitter_output *output, int address, unsigned int word) {
+    add_to_record(output, address, word, flush_srec_record);
+}
+
+/*
+ * Function: add_run_to_records
+ * ----------------------------
+ * Adds a run of the same word to the data records. The memory the records don't cover is 0 when it is loaded,
+ * so a run of 0 words ends the record that is being filled and is left out of the file.
+ *
+ * output: The output.
+ * address: The address of the first word of the run.
+ * word: The word of the run.
+ * count: The amount of words in the run.
+ * flush_record: Writes the record in the format of the output.
+ */
+static void add_run_to_records(struct emitter_output *output, int address, unsigned int word, int count,
+                               void (*flush_record)(struct emitter_output *)) {
+    if (word == 0) {
+        flush_record(output);
+        return;
+    }
+
+    for (; count > 0; --count, ++address) {
+        add_to_record(output, address, word, flush_record);
+    }
+}
+
+static void write_ihex_run(struct emitter_output *output, int address, unsigned int word, int count) {
+    add_run_to_records(output, address, word, count, flush_ihex_record);
+}
+
+static void write_srec_run(struct emitter_output *output, int address, unsigned int word, int count) {
+    add_run_to_records(output, address, word, count, flush_srec_record);
+}
+
+/*
+ * Function: flush_rle_run
+ * -----------------------
+ * Writes the run that is being counted as a line of three hexadecimal digits, followed by '*' and the amount
+ * of words when there is more than one.
+ */
+static void flush_rle_run(struct emitter_output *output) {
+    char line[16];
+    int line_length = 3;
+
+    if (output->run_count == 0) {
+        return;
+    }
+
+    line[0] = hex_digits[(output->run_word >> 8) & 0xF];
+    line[1] = hex_digits[(output->run_word >> 4) & 0xF];
+    line[2] = hex_digits[output->run_word & 0xF];
+    if (output->run_count > 1) {
+        line_length += sprintf(line + line_length, "*%d", output->run_count);
+    }
+    line[line_length++] = '\n';
+
+    write_output(output, line, line_length);
+    output->run_count = 0;
+}
+
+/*
+ * Function: write_rle_run
+ * -----------------------
+ * Counts a run of the same word, it is written when a different word comes.
+ * Equal words are merged whether they were reserved by .space or coded one by one.
+ */
+static void write_rle_run(struct emitter_output *output, int address, unsigned int word, int count) {
+    if (output->run_count > 0 && output->run_word != word) {
+        flush_rle_run(output);
+    }
+
+    output->run_word = word;
+    output->run_count += count;
+}
+
+static void write_rle_word(struct emitter_output *output, int address, unsigned int word) {
+    write_rle_run(output, address, word, 1);
+}
+
+/*
+ * Function: end_ihex
+ * ------------------
+ * Writes the last data record and the end of file record.
+ */
+static void end_ihex(struct emitter_output *output) {
+    flush_ihex_record(output);
+    write_ihex_record(output, 1, 0, NULL, 0);
+}
+
+/*
+ * Function: begin_srec
+ * --------------------
+ * Writes the header record, its data is the name of the file (at most RECORD_SIZE characters).
+ */
+static void begin_srec(struct emitter_output *output, int inst_length, int dir_length, const char *file_name) {
+    int length = (int) strlen(file_name);
+
+    write_srec_record(output, '0', 0, (const unsigned char *) file_name, length > RECORD_SIZE ? RECORD_SIZE : length);
+}
+
+/*
+ * Function: end_srec
+ * ------------------
+ * Writes the last data record, the count of the data records, and the start address (the byte address of the first word).
+ */
+static void end_srec(struct emitter_output *output) {
+    flush_srec_record(output);
+    write_srec_record(output, '5', output->records_count, NULL, 0);
+    write_srec_record(output, '9', 2 * BASE_ADDRESS, NULL, 0);
+}
+
+/*
+ * The emitters, indexed by their formats.
+ */
+static const struct emitter emitters[AMOUNT_OF_EMITTERS] = {
+        {".obj",  write_counts_header, write_base64_word, NULL,           NULL},
+        {".b16",  write_counts_header, write_base16_word, NULL,           NULL},
+        {".bin",  NULL,                write_bin_word,    NULL,           NULL},
+        {".hex",  NULL,                write_ihex_word,   write_ihex_run, end_ihex},
+        {".srec", begin_srec,          write_srec_word,   write_srec_run, end_srec},
+        {".rle",  write_counts_header, write_rle_word,    write_rle_run,  flush_rle_run}
+};
+
+/*
+ * The names of the formats in --format, indexed by the formats.
+ */
+static const char *format_names[AMOUNT_OF_FORMATS] = {"base64", "base16", "bin", "ihex", "srec", "rle", "object"};
+
+/*
+ * Function: parse_object_formats
+ * ------------------------------
+ * Parses a list of format names separated by commas, as given to --format.
+ *
+ * names: The list of the names.
+ *
+ * returns: The mask of the formats, or -1 if a name isn't a format.
+ */
+int parse_object_formats(const char *names) {
+    int formats = 0, length, i;
+
+    while (true) {
+        length = (int) strcspn(names, ",");
+
+        for (i = 0; i < AMOUNT_OF_FORMATS; ++i) {
+            if ((int) strlen(format_names[i]) == length && strncmp(format_names[i], names, length) == 0) {
+                break;
+            }
+        }
+        if (i == AMOUNT_OF_FORMATS) {
+            return -1;
+        }
+        formats |= FORMAT_BIT(i);
+
+        if (names[length] == '\0') {
+            return formats;
+        }
+        names += length + 1;
+    }
+}
+
+/*
+ * Function: emit_words
+ * --------------------
+ * Streams the words of a coded list to all the outputs, a run is passed at once to the emitters that take runs.
+ *
+ * outputs: The outputs.
+ * outputs_count: The amount of outputs.
+ * list: The coded list.
+ * first_address: The address of the first word.
+ */
+static void emit_words(struct emitter_output *outputs, int outputs_count, const struct coded_list *list,
+                       int first_address) {
+    struct word_cursor words;
+    unsigned int word;
+    int address = first_address, count, i, j;
+
+    init_word_cursor(&words, list);
+    while ((count = next_words(&words, &word)) > 0) {
+        for (j = 0; j < outputs_count; ++j) {
+            if (count > 1 && outputs[j].emitter->run != NULL) {
+                outputs[j].emitter->run(&outputs[j], address, word, count);
+                continue;
+            }
+            for (i = 0; i < count; ++i) {
+                outputs[j].emitter->word(&outputs[j], address + i, word);
+            }
+        }
+        address += count;
+    }
+}
+
+/*
+ * Function: write_object_files
+ * ----------------------------
+ * Writes the object in each of the requested formats that have an emitter, to the output with the ending
+ * of the format (a format whose output can't be opened is left out).
+ * The resolved words are traversed once, the instructions and then the directives, and every word
+ * is passed to all the emitters.
+ *
+ * inst_coded_list: The coded instructions, already patched.
+ * dir_coded_list: The coded directives.
+ * outputs: The outputs of the source.
+ * formats: The mask of the requested formats.
+ */
+void write_object_files(const struct coded_list *inst_coded_list, const struct coded_list *dir_coded_list,
+                        struct output_files *outputs, int formats) {
+    struct emitter_output *emitter_outputs = (struct emitter_output *) malloc(AMOUNT_OF_EMITTERS *
+                                                                              sizeof(struct emitter_output));
+    struct emitter_output *output;
+    int outputs_count = 0, i;
+
+    if (emitter_outputs == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < AMOUNT_OF_EMITTERS; ++i) {
+        if (formats & FORMAT_BIT(i)) {
+            output = &emitter_outputs[outputs_count];
+            output->emitter = &emitters[i];
+            output->file = open_output(outputs, emitters[i].ending);
+            if (output->file == NULL) {
+                continue;
+            }
+            outputs_count++;
+            output->length = 0;
+            output->record_length = 0;
+            output->record_address = 0;
+            output->records_count = 0;
+            output->run_count = 0;
+
+            if (output->emitter->begin != NULL) {
+                output->emitter->begin(output, inst_coded_list->length, dir_coded_list->length, outputs->file_name);
+            }
+        }
+    }
+
+    emit_words(emitter_outputs, outputs_count, inst_coded_list, BASE_ADDRESS);
+    emit_words(emitter_outputs, outputs_count, dir_coded_list, BASE_ADDRESS + inst_coded_list->length);
+
+    for (i = 0; i < outputs_count; ++i) {
+        output = &emitter_outputs[i];
+        if (output->emitter->end != NULL) {
+            output->emitter->end(output);
+        }
+        flush_output(output);
+        close_output(outputs, output->file);
+    }
+
+    free(emitter_outputs);
+}
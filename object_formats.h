@@ -0,0 +1,37 @@
+#ifndef ASSEMBLER_OBJECT_FORMATS_H
+#define ASSEMBLER_OBJECT_FORMATS_H
+
+#include "coded_list.h"
+#include "utils.h"
+#include "output_files.h"
+
+/*
+ * The encodings the object can be written in, each to its own file.
+ * The formats that are a stream of the words (with an emitter) come first, the binary object file
+ * also holds the symbols and the relocations.
+ */
+enum object_format {
+    format_base64,
+    format_base16,
+    format_bin,
+    format_ihex,
+    format_srec,
+    format_rle,
+    format_object
+};
+
+#define AMOUNT_OF_EMITTERS 6
+#define AMOUNT_OF_FORMATS 7
+
+/*
+ * A set of formats is a mask of their bits, the default is the base 64 .obj file.
+ * The text .ent and .ext files come with the .obj file, so they are written only when base64 is requested.
+ */
+#define FORMAT_BIT(format) (1 << (format))
+#define DEFAULT_FORMATS FORMAT_BIT(format_base64)
+
+int parse_object_formats(const char *names);
+void write_object_files(const struct coded_list *inst_coded_list, const struct coded_list *dir_coded_list,
+                        struct output_files *outputs, int formats);
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * The outputs of a source, written to files or framed on a stream, see output_files.h.
+ * A framed output needs its size before its bytes, so it is kept in memory until it is closed.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "output_files.h"
+
+/*
+ * Function: init_output_files
+ * ---------------------------
+ * Initializes the outputs of a source as files.
+ *
+ * outputs: The outputs.
+ * file_name: The name of the files, without the ending.
+ * messages: The stream the outputs that can't be opened are reported to.
+ */
+void init_output_files(struct output_files *outputs, const char *file_name, FILE *messages) {
+    init_output_stream(outputs, file_name, messages, NULL, -1, -1, -1);
+}
+
+/*
+ * Function: init_output_stream
+ * ----------------------------
+ * Initializes the outputs of a source as sections of a stream, or as file descriptors.
+ *
+ * outputs: The outputs.
+ * file_name: The name of the source.
+ * messages: The stream the outputs that can't be opened are reported to.
+ * stream: The stream the sections are written to, NULL to write files.
+ * obj_fd: The file descriptor the .obj output is written to, -1 to write it as a section.
+ * ent_fd: The file descriptor the .ent output is written to, -1 to write it as a section.
+ * ext_fd: The file descriptor the .ext output is written to, -1 to write it as a section.
+ */
+void init_output_stream(struct output_files *outputs, const char *file_name, FILE *messages, FILE *stream,
+                        int obj_fd, int ent_fd, int ext_fd) {
+    int i = 0;
+
+    outputs->file_name = file_name;
+    outputs->messages = messages;
+    outputs->failed = false;
+    outputs->stream = stream;
+    outputs->obj_fd = obj_fd;
+    outputs->ent_fd = ent_fd;
+    outputs->ext_fd = ext_fd;
+    for (; i < MAX_OPEN_SECTIONS; ++i) {
+        outputs->sections[i].file = NULL;
+    }
+}
+
+/*
+ * Function: output_fd
+ * -------------------
+ * Finds the file descriptor an output is written to.
+ *
+ * returns: The file descriptor, -1 if the output has none.
+ */
+static int output_fd(const struct output_files *outputs, const char *ending) {
+    if (strcmp(ending, ".obj") == 0) {
+        return outputs->obj_fd;
+    }
+    if (strcmp(ending, ".ent") == 0) {
+        return outputs->ent_fd;
+    }
+    if (strcmp(ending, ".ext") == 0) {
+        return outputs->ext_fd;
+    }
+    return -1;
+}
+
+/*
+ * Function: open_output
+ * ---------------------
+ * Opens an output of the source. An output that can't be opened is reported, and the outputs are marked as failed.
+ *
+ * outputs: The outputs.
+ * ending: The ending of the file of the output.
+ *
+ * returns: The stream the output is written to, to be closed with close_output. NULL if it can't be opened.
+ */
+FILE *open_output(struct output_files *outputs, const char *ending) {
+    struct output_section *section = outputs->sections;
+    int fd = output_fd(outputs, ending), copy, i = 0;
+    FILE *file;
+
+    if (outputs->stream == NULL) {
+        file = open_output_file(outputs->file_name, ending);
+        if (file == NULL) {
+            fprintf(outputs->messages, "There Was Problem With Open The File %s%s\n", outputs->file_name, ending);
+            outputs->failed = true;
+        }
+        return file;
+    }
+
+    /*
+     * The stream is closed with the output, the file descriptor of the caller stays open
+     */
+    if (fd != -1) {
+        copy = dup(fd);
+        file = copy != -1 ? fdopen(copy, "w") : NULL;
+        if (file == NULL) {
+            if (copy != -1) {
+                close(copy);
+            }
+            fprintf(outputs->messages, "There Was Problem With Open The File Descriptor %d\n", fd);
+            outputs->failed = true;
+        }
+        return file;
+    }
+
+    for (; i < MAX_OPEN_SECTIONS && section->file != NULL; ++i, ++section);
+    if (i == MAX_OPEN_SECTIONS) {
+        fprintf(outputs->messages, "There Was Problem With Open The Section %s\n", ending);
+        outputs->failed = true;
+        return NULL;
+    }
+
+    section->file = open_memstream(&section->data, &section->size);
+    if (section->file == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+    section->ending = ending;
+
+    return section->file;
+}
+
+/*
+ * Function: close_output
+ * ----------------------
+ * Closes an output of the source, an output that is a section is written to the stream with its frame.
+ *
+ * outputs: The outputs.
+ * file: The stream of the output.
+ */
+void close_output(struct output_files *outputs, FILE *file) {
+    struct output_section *section = outputs->sections;
+    int i = 0;
+
+    for (; i < MAX_OPEN_SECTIONS && section->file != file; ++i, ++section);
+    fclose(file);
+    if (i == MAX_OPEN_SECTIONS) {
+        return;
+    }
+
+    fprintf(outputs->stream, "%s %lu\n", section->ending + 1, (unsigned long) section->size);
+    fwrite(section->data, 1, section->size, outputs->stream);
+    free(section->data);
+    section->file = NULL;
+}
@@ -0,0 +1,48 @@
+#ifndef ASSEMBLER_OUTPUT_FILES_H
+#define ASSEMBLER_OUTPUT_FILES_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "utils.h"
+
+/*
+ * The most outputs that are written at once (every emitter of the object formats has its output open).
+ */
+#define MAX_OPEN_SECTIONS 8
+
+/*
+ * An output that is being written to memory, to be framed on the stream once it is closed.
+ */
+struct output_section {
+    FILE *file;
+    const char *ending;
+    char *data;
+    size_t size;
+};
+
+/*
+ * Where the outputs of a source (.obj, .ent, .ext, ...) are written. Every output is known by the ending of its file.
+ * Without a stream, an output is the file of file_name with its ending. With a stream, the .obj, .ent and .ext
+ * outputs are written as they are to their file descriptors when they were given (-1 otherwise), and any other
+ * output is written to the stream as a section: a line of its ending (without the '.') and its size in bytes,
+ * followed by its bytes. file_name is also the name of the source in the outputs that hold it.
+ * An output that can't be opened is reported to messages, and failed is set.
+ */
+struct output_files {
+    const char *file_name;
+    FILE *messages;
+    bool failed;
+    FILE *stream;
+    int obj_fd;
+    int ent_fd;
+    int ext_fd;
+    struct output_section sections[MAX_OPEN_SECTIONS];
+};
+
+void init_output_files(struct output_files *outputs, const char *file_name, FILE *messages);
+void init_output_stream(struct output_files *outputs, const char *file_name, FILE *messages, FILE *stream,
+                        int obj_fd, int ent_fd, int ext_fd);
+FILE *open_output(struct output_files *outputs, const char *ending);
+void close_output(struct output_files *outputs, FILE *file);
+
+#endif
@@ -1,14 +1,18 @@
-#ifndef ASSEMBLER_SECOND_PASS_H
-#define ASSEMBLER_SECOND_PASS_H
-
-#include <stdio.h>
-#include "symbol_table.h"
-#include "coded_list.h"
-#include "stdio.h"
-#include "utils.h"
-
-
-void second_pass(struct symbol_list *symbols, struct coded_list *inst_coded_list,
-                 struct coded_list *dir_coded_list, char *file_name);
-
-#endif
+#ifndef ASSEMBLER_SECOND_PASS_H
+#define ASSEMBLER_SECOND_PASS_H
+
+#include <stdio.h>
+#include "symbol_table.h"
+#include "coded_list.h"
+#include "object_formats.h"
+#include "binary_object.h"
+#include "output_files.h"
+#include "stdio.h"
+#include "utils.h"
+
+
+void patch_fixups(const struct symbol_table *symbols, struct coded_list *inst_coded_list);
+bool second_pass(const struct symbol_table *symbols, struct coded_list *inst_coded_list,
+                struct coded_list *dir_coded_list, struct output_files *outputs, int formats);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * The server mode of the assembler: the process stays alive and runs the command lines of its clients,
+ * so a client doesn't pay for the start of a process (loading, the start of the sanitizer, cold caches).
+ * Every connection is served by a thread of its own, the assembler keeps no global state, so the command lines
+ * of the clients run at the same time. A connection can send many requests, one after the other.
+ * A client can also send its standard input: it is assembled in memory and its outputs are sent back,
+ * so nothing is read or written on the disk for it.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include "server.h"
+#include "socket_io.h"
+#include "cli.h"
+
+/*
+ * Function: serve_request
+ * -----------------------
+ * Runs the command line of a request and sends its response: the exit status, the messages,
+ * and the outputs of the source of a request_source.
+ *
+ * fd: The connection.
+ * kind: The kind of the request, the source of a request_source is received here.
+ * strings: The directory of the client, and the arguments of its command line.
+ * count: The amount of strings.
+ *
+ * returns: False if the connection was closed or failed, or the request can't be answered.
+ */
+static bool serve_request(int fd, enum request_kind kind, char **strings, int count) {
+    struct client_source client_source;
+    FILE *messages, *outputs = NULL;
+    char *source = NULL;
+    bool is_answered;
+    int status;
+
+    if (kind == request_source && (source = receive_source(fd, &client_source.size)) == NULL) {
+        return false;
+    }
+
+    messages = tmpfile();
+    if (messages != NULL && kind == request_source) {
+        outputs = tmpfile();
+    }
+    if (messages == NULL || (kind == request_source && outputs == NULL)) {
+        printf("There Was Problem With Open A Temporary File\n");
+        if (messages != NULL) {
+            fclose(messages);
+        }
+        free(source);
+        return false;
+    }
+
+    /*
+     * The first string is the directory of the client, the others are its arguments
+     */
+    client_source.data = source;
+    client_source.outputs = outputs;
+    status = run_command_line(count - 1, strings + 1, strings[0], kind == request_source ? &client_source : NULL,
+                              messages);
+    is_answered = send_number(fd, status) && send_stream(fd, messages) &&
+                  (outputs == NULL || send_stream(fd, outputs));
+
+    fclose(messages);
+    if (outputs != NULL) {
+        fclose(outputs);
+    }
+    free(source);
+    return is_answered;
+}
+
+/*
+ * Function: serve_connection
+ * --------------------------
+ * The thread of a connection: runs the requests of the connection until it is closed.
+ * A request that can't be answered closes only its connection.
+ *
+ * argument: The connection, allocated by the server.
+ */
+static void *serve_connection(void *argument) {
+    int fd = *(int *) argument, count;
+    enum request_kind kind;
+    char **strings;
+    bool is_open = true;
+
+    free(argument);
+
+    /*
+     * The server writes files with the permissions of its user, so only the same user is served
+     */
+    if (!is_same_user(fd)) {
+        printf("A Client Of Another User Was Refused\n");
+        fflush(stdout);
+        close(fd);
+        return NULL;
+    }
+
+    while (is_open && (strings = receive_request(fd, &kind, &count)) != NULL) {
+        is_open = serve_request(fd, kind, strings, count);
+        free_request(strings, count);
+    }
+
+    close(fd);
+    return NULL;
+}
+
+/*
+ * Function: serve
+ * ---------------
+ * Listens on a Unix domain socket and serves the clients that connect to it, until the process is stopped.
+ *
+ * socket_path: The path of the socket, an old socket in this path is removed (any other file is kept).
+ *
+ * returns: 1 if the socket couldn't be made.
+ */
+int serve(const char *socket_path) {
+    struct sockaddr_un address;
+    struct stat file_stat;
+    pthread_attr_t detached;
+    pthread_t thread;
+    int listener, *connection;
+
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("The Socket Path %s Is Too Long\n", socket_path);
+        return 1;
+    }
+
+    /*
+     * A client that leaves early shouldn't stop the server
+     */
+    signal(SIGPIPE, SIG_IGN);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    /*
+     * Only a socket that was left by an old server is removed, a mistyped path mustn't delete a file
+     */
+    if (lstat(socket_path, &file_stat) == 0) {
+        if (!S_ISSOCK(file_stat.st_mode)) {
+            printf("%s Isn't A Socket, The Server Won't Replace It\n", socket_path);
+            return 1;
+        }
+        unlink(socket_path);
+    }
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, (struct sockaddr *) &address, sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        printf("There Was Problem With Listen On %s\n", socket_path);
+        return 1;
+    }
+
+    printf("Serving On %s\n", socket_path);
+    fflush(stdout);
+
+    pthread_attr_init(&detached);
+    pthread_attr_setdetachstate(&detached, PTHREAD_CREATE_DETACHED);
+
+    while (true) {
+        connection = (int *) malloc(sizeof(int));
+        if (connection == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+
+        *connection = accept(listener, NULL, NULL);
+        if (*connection < 0) {
+            free(connection);
+            continue;
+        }
+
+        if (pthread_create(&thread, &detached, serve_connection, connection) != 0) {
+            close(*connection);
+            free(connection);
+        }
+    }
+}
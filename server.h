@@ -0,0 +1,6 @@
+#ifndef ASSEMBLER_SERVER_H
+#define ASSEMBLER_SERVER_H
+
+int serve(const char *socket_path);
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * Sends and receives the messages between the client and the server, see socket_io.h.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "socket_io.h"
+
+/*
+ * Function: get_default_socket_path
+ * ---------------------------------
+ * Makes the path of the socket of the server when no other path is given. A directory that every user
+ * can write to (the fallback) is shared with the other users, so the server and the client only trust
+ * a peer of the same user (see is_same_user).
+ *
+ * path: The place of the path, MAX_PATH_SIZE characters.
+ */
+void get_default_socket_path(char *path) {
+    const char *directory = getenv("XDG_RUNTIME_DIR");
+
+    if (directory != NULL && directory[0] != '\0' &&
+        strlen(directory) + strlen(DEFAULT_SOCKET_NAME) + 2 <= MAX_PATH_SIZE) {
+        sprintf(path, "%s/%s", directory, DEFAULT_SOCKET_NAME);
+    } else {
+        sprintf(path, "%s/assembler-%lu.socket", FALLBACK_SOCKET_DIRECTORY, (unsigned long) geteuid());
+    }
+}
+
+/*
+ * Function: is_same_user
+ * ----------------------
+ * Checks that the process on the other side of a connection runs as the same user as this process.
+ *
+ * fd: The connection.
+ *
+ * returns: True if the peer is of the same user.
+ */
+bool is_same_user(int fd) {
+    struct ucred peer;
+    socklen_t length = sizeof(peer);
+
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &length) == 0 && peer.uid == geteuid();
+}
+
+/*
+ * Function: send_all
+ * ------------------
+ * Sends all the bytes, a write may send only a part of them.
+ *
+ * returns: False if the socket was closed or failed.
+ */
+bool send_all(int fd, const void *data, size_t size) {
+    const char *bytes = (const char *) data;
+    ssize_t sent;
+
+    while (size > 0) {
+        sent = write(fd, bytes, size);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= sent;
+    }
+
+    return true;
+}
+
+/*
+ * Function: receive_all
+ * ---------------------
+ * Receives exactly size bytes.
+ *
+ * returns: False if the socket was closed before, or failed.
+ */
+bool receive_all(int fd, void *data, size_t size) {
+    char *bytes = (char *) data;
+    ssize_t received;
+
+    while (size > 0) {
+        received = read(fd, bytes, size);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= received;
+    }
+
+    return true;
+}
+
+/*
+ * Function: send_number
+ * ---------------------
+ * Sends a 32-bit number, in network byte order.
+ */
+bool send_number(int fd, unsigned long number) {
+    uint32_t value = htonl((uint32_t) number);
+
+    return send_all(fd, &value, sizeof(value));
+}
+
+/*
+ * Function: receive_number
+ * ------------------------
+ * Receives a 32-bit number, in network byte order.
+ */
+bool receive_number(int fd, unsigned long *number) {
+    uint32_t value;
+
+    if (!receive_all(fd, &value, sizeof(value))) {
+        return false;
+    }
+    *number = ntohl(value);
+    return true;
+}
+
+/*
+ * Function: send_request
+ * ----------------------
+ * Sends a request: its kind, the directory of the client, and the arguments of its command line
+ * (the source of a request_source is sent after it with send_stream).
+ *
+ * returns: False if the socket was closed or failed.
+ */
+bool send_request(int fd, enum request_kind kind, const char *directory, int count, char **arguments) {
+    int i = 0;
+
+    if (!send_number(fd, kind) || !send_number(fd, count + 1) || !send_number(fd, strlen(directory)) ||
+        !send_all(fd, directory, strlen(directory))) {
+        return false;
+    }
+
+    for (; i < count; ++i) {
+        if (!send_number(fd, strlen(arguments[i])) || !send_all(fd, arguments[i], strlen(arguments[i]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Function: receive_request
+ * -------------------------
+ * Receives a request, every string is null terminated (the source of a request_source is received
+ * after it with receive_source).
+ *
+ * socket: The socket.
+ * kind: Pointer to the variable to store the kind of the request.
+ * count: Pointer to the variable to store the amount of strings.
+ *
+ * returns: The strings (freed with free_request), NULL if the socket was closed, failed, or the request
+ * is over the limits.
+ */
+char **receive_request(int fd, enum request_kind *kind, int *count) {
+    char **strings;
+    unsigned long request_kind, strings_count, length;
+    int i;
+
+    if (!receive_number(fd, &request_kind) || (request_kind != request_files && request_kind != request_source) ||
+        !receive_number(fd, &strings_count) || strings_count == 0 || strings_count > MAX_REQUEST_STRINGS) {
+        return NULL;
+    }
+    *kind = (enum request_kind) request_kind;
+
+    strings = (char **) calloc(strings_count, sizeof(char *));
+    if (strings == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < (int) strings_count; ++i) {
+        if (!receive_number(fd, &length) || length > MAX_REQUEST_STRING_LENGTH) {
+            free_request(strings, i);
+            return NULL;
+        }
+
+        strings[i] = (char *) malloc(length + 1);
+        if (strings[i] == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        if (!receive_all(fd, strings[i], length)) {
+            free_request(strings, i + 1);
+            return NULL;
+        }
+        strings[i][length] = '\0';
+    }
+
+    *count = (int) strings_count;
+    return strings;
+}
+
+/*
+ * Function: send_stream
+ * ---------------------
+ * Sends the content of a stream from its start, as its length and its bytes.
+ *
+ * returns: False if the socket was closed or failed, or the stream can't be read.
+ */
+bool send_stream(int fd, FILE *stream) {
+    char buffer[4096];
+    long length;
+    size_t read_length;
+
+    if (fseek(stream, 0, SEEK_END) != 0 || (length = ftell(stream)) < 0 || !send_number(fd, length)) {
+        return false;
+    }
+
+    rewind(stream);
+    while ((read_length = fread(buffer, 1, sizeof(buffer), stream)) > 0) {
+        if (!send_all(fd, buffer, read_length)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Function: receive_source
+ * ------------------------
+ * Receives the source of a request_source.
+ *
+ * socket: The socket.
+ * size: Pointer to the variable to store the size of the source.
+ *
+ * returns: The source (freed with free), NULL if the socket was closed, failed, or the source is over the limit.
+ */
+char *receive_source(int fd, long *size) {
+    unsigned long length;
+    char *source;
+
+    if (!receive_number(fd, &length) || length > MAX_REQUEST_SOURCE_SIZE) {
+        return NULL;
+    }
+
+    /*
+     * An empty source is still a source, so something is allocated for it
+     */
+    source = (char *) malloc(length + 1);
+    if (source == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+    if (!receive_all(fd, source, length)) {
+        free(source);
+        return NULL;
+    }
+
+    *size = (long) length;
+    return source;
+}
+
+/*
+ * Function: free_request
+ * ----------------------
+ * Frees the strings of a request.
+ */
+void free_request(char **strings, int count) {
+    int i = 0;
+
+    for (; i < count; ++i) {
+        free(strings[i]);
+    }
+    free(strings);
+}
@@ -0,0 +1,54 @@
+#ifndef ASSEMBLER_SOCKET_IO_H
+#define ASSEMBLER_SOCKET_IO_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "utils.h"
+
+/*
+ * The name of the socket of the server, when no other path is given (the client reads it from ASSEMBLER_SOCKET).
+ * It is in the private runtime directory of the user (XDG_RUNTIME_DIR), or in FALLBACK_SOCKET_DIRECTORY
+ * with the id of the user in its name.
+ */
+#define DEFAULT_SOCKET_NAME "assembler.socket"
+#define FALLBACK_SOCKET_DIRECTORY "/tmp"
+
+/*
+ * The limits of a request, a request over them is refused.
+ */
+#define MAX_REQUEST_STRINGS 65536
+#define MAX_REQUEST_STRING_LENGTH 65536
+#define MAX_REQUEST_SOURCE_SIZE (64L * 1024 * 1024)
+
+/*
+ * The kinds of requests: the files of a request_files are read and written by the server (in the directory
+ * of the client), a request_source also carries the standard input of the client, which is assembled in memory
+ * and whose outputs are sent back to the client.
+ */
+enum request_kind {
+    request_files,
+    request_source
+};
+
+/*
+ * The messages between the client and the server, every number is a 32-bit unsigned integer in network byte order.
+ * A request is its kind, the amount of strings, and every string as its length and its characters: the first string
+ * is the directory of the client, and the others are the arguments of the command line. A request_source is followed
+ * by the source, as its length and its bytes.
+ * A response is the exit status and the messages of the command line, as their length and their characters.
+ * The response to a request_source is followed by the outputs of the source, as their length and their bytes
+ * (sections, as the standard output of "assembler -").
+ */
+void get_default_socket_path(char *path);
+bool is_same_user(int fd);
+bool send_all(int fd, const void *data, size_t size);
+bool receive_all(int fd, void *data, size_t size);
+bool send_number(int fd, unsigned long number);
+bool receive_number(int fd, unsigned long *number);
+bool send_request(int fd, enum request_kind kind, const char *directory, int count, char **arguments);
+char **receive_request(int fd, enum request_kind *kind, int *count);
+bool send_stream(int fd, FILE *stream);
+char *receive_source(int fd, long *size);
+void free_request(char **strings, int count);
+
+#endif
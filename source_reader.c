@@ -0,0 +1,357 @@
+/*
+ * This code loads a source file into memory and builds its line index: where every line starts,
+ * and which lines are comments. The index is built with SSE2/AVX2 when they are available,
+ * 16/32 characters at a time, and with a plain loop otherwise.
+ * The commas aren't indexed: the lexer reads the lines of the expanded source (not of the file),
+ * and its operands automaton follows the commas in the same scan that classifies the operands.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "source_reader.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USE_SIMD
+#include <immintrin.h>
+#endif
+
+/*
+ * Growable array of offsets, used while the index is built.
+ */
+struct offsets {
+    int *data;
+    int count;
+    int capacity;
+};
+
+/*
+ * Function: add_offset
+ * --------------------
+ * Adds an offset to the end of the array.
+ */
+static void add_offset(struct offsets *offsets, int offset) {
+    if (offsets->count == offsets->capacity) {
+        int *grown;
+
+        offsets->capacity = offsets->capacity == 0 ? 64 : offsets->capacity * 2;
+        grown = (int *) realloc(offsets->data, offsets->capacity * sizeof(int));
+        if (grown == NULL) {
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        offsets->data = grown;
+    }
+    offsets->data[offsets->count++] = offset;
+}
+
+/*
+ * Function: index_char
+ * --------------------
+ * Adds a single character to the index.
+ *
+ * data: The content of the file.
+ * size: The size of the content.
+ * i: The offset of the character.
+ */
+static void index_char(const char *data, long size, long i, struct offsets *lines, struct offsets *comments) {
+    if (data[i] == '\n' && i + 1 < size) {
+        add_offset(lines, i + 1);
+    } else if (data[i] == ';' && (i == 0 || data[i - 1] == '\n')) {
+        add_offset(comments, i);
+    }
+}
+
+#ifdef USE_SIMD
+/*
+ * Function: index_mask
+ * --------------------
+ * Adds the characters of a block that were marked by the vector compare.
+ *
+ * mask: Bit i is set if the i-th character of the block is '\n' or ';'.
+ * block: The offset of the block.
+ */
+static void index_mask(const char *data, long size, long block, unsigned int mask,
+                       struct offsets *lines, struct offsets *comments) {
+    while (mask != 0) {
+        index_char(data, size, block + __builtin_ctz(mask), lines, comments);
+        mask &= mask - 1;
+    }
+}
+
+/*
+ * Function: index_avx2
+ * --------------------
+ * Indexes the content 32 characters at a time.
+ *
+ * returns: The offset of the first character that wasn't indexed.
+ */
+__attribute__((target("avx2")))
+static long index_avx2(const char *data, long size, struct offsets *lines, struct offsets *comments) {
+    const __m256i new_line = _mm256_set1_epi8('\n'), semicolon = _mm256_set1_epi8(';');
+    long i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (data + i));
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, new_line), _mm256_cmpeq_epi8(block, semicolon)));
+        index_mask(data, size, i, mask, lines, comments);
+    }
+    return i;
+}
+
+/*
+ * Function: index_sse2
+ * --------------------
+ * Indexes the content 16 characters at a time.
+ *
+ * returns: The offset of the first character that wasn't indexed.
+ */
+__attribute__((target("sse2")))
+static long index_sse2(const char *data, long size, struct offsets *lines, struct offsets *comments) {
+    const __m128i new_line = _mm_set1_epi8('\n'), semicolon = _mm_set1_epi8(';');
+    long i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (data + i));
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(block, new_line), _mm_cmpeq_epi8(block, semicolon)));
+        index_mask(data, size, i, mask, lines, comments);
+    }
+    return i;
+}
+#endif
+
+/*
+ * Function: build_index
+ * ---------------------
+ * Builds the line index of the source in one pass.
+ *
+ * source: The source file, its content is already loaded.
+ */
+static void build_index(struct source_file *source) {
+    struct offsets lines = {NULL, 0, 0}, comments = {NULL, 0, 0};
+    long i = 0;
+
+    if (source->size > 0) {
+        add_offset(&lines, 0);
+    }
+
+#ifdef USE_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        i = index_avx2(source->data, source->size, &lines, &comments);
+    } else if (__builtin_cpu_supports("sse2")) {
+        i = index_sse2(source->data, source->size, &lines, &comments);
+    }
+#endif
+
+    /* The tail of the content (or all of it, without SIMD) */
+    for (; i < source->size; ++i) {
+        index_char(source->data, source->size, i, &lines, &comments);
+    }
+
+    source->line_starts = lines.data;
+    source->lines_count = lines.count;
+    source->comment_starts = comments.data;
+    source->comments_count = comments.count;
+}
+
+/*
+ * Function: read_file
+ * -------------------
+ * Reads the whole file into a buffer, when it can't be mapped.
+ *
+ * returns: True on success, false otherwise.
+ */
+static bool read_file(struct source_file *source, int fd) {
+    long capacity = 4096;
+    ssize_t n;
+
+    source->data = (char *) malloc(capacity);
+    source->size = 0;
+    source->is_mapped = false;
+    source->is_borrowed = false;
+    if (source->data == NULL) {
+        return false;
+    }
+
+    while ((n = read(fd, source->data + source->size, capacity - source->size)) > 0) {
+        source->size += n;
+        if (source->size == capacity) {
+            char *grown;
+
+            capacity *= 2;
+            grown = (char *) realloc(source->data, capacity);
+            if (grown == NULL) {
+                return false;
+            }
+            source->data = grown;
+        }
+    }
+
+    return n == 0;
+}
+
+/*
+ * Function: source_file_size
+ * --------------------------
+ * Gets the size of a source file without loading it.
+ *
+ * file_name: The name of the file.
+ *
+ * returns: The size of the file in bytes, -1 if the file doesn't exist.
+ */
+long source_file_size(const char *file_name) {
+    struct stat file_stat;
+
+    if (stat(file_name, &file_stat) != 0) {
+        return -1;
+    }
+
+    return (long) file_stat.st_size;
+}
+
+/*
+ * Function: load_source
+ * ---------------------
+ * Loads the content of an open file into memory and builds its line index.
+ * A regular file is mapped, anything else (like a pipe) is read to its end.
+ *
+ * source: The source file to fill.
+ * fd: The file descriptor, it isn't closed.
+ *
+ * returns: True on success, false if the file couldn't be read.
+ */
+static bool load_source(struct source_file *source, int fd) {
+    struct stat file_stat;
+    bool is_loaded = false;
+
+    source->data = NULL;
+    source->line_starts = NULL;
+    source->comment_starts = NULL;
+    source->lines_count = source->comments_count = 0;
+
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+        source->data = (char *) mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (source->data != MAP_FAILED) {
+            source->size = file_stat.st_size;
+            source->is_mapped = true;
+            source->is_borrowed = false;
+            is_loaded = true;
+        } else {
+            source->data = NULL;
+        }
+    }
+    if (!is_loaded) {
+        is_loaded = read_file(source, fd);
+    }
+
+    if (!is_loaded) {
+        close_source_file(source);
+        return false;
+    }
+
+    build_index(source);
+    return true;
+}
+
+/*
+ * Function: open_source_file
+ * --------------------------
+ * Loads a source file into memory and builds its line index.
+ *
+ * source: The source file to fill.
+ * file_name: The name of the file.
+ *
+ * returns: True on success, false if the file couldn't be opened or read.
+ */
+bool open_source_file(struct source_file *source, const char *file_name) {
+    int fd = open(file_name, O_RDONLY);
+    bool is_loaded;
+
+    if (fd == -1) {
+        source->data = NULL;
+        source->line_starts = NULL;
+        source->comment_starts = NULL;
+        source->lines_count = source->comments_count = 0;
+        return false;
+    }
+
+    is_loaded = load_source(source, fd);
+    close(fd);
+    return is_loaded;
+}
+
+/*
+ * Function: open_source_fd
+ * ------------------------
+ * Loads a source from a file descriptor that is already open, like the standard input.
+ *
+ * source: The source file to fill.
+ * fd: The file descriptor, it isn't closed.
+ *
+ * returns: True on success, false if the file couldn't be read.
+ */
+bool open_source_fd(struct source_file *source, int fd) {
+    return load_source(source, fd);
+}
+
+/*
+ * Function: open_source_buffer
+ * ----------------------------
+ * Makes a source of a buffer that is already in memory and builds its line index, the buffer isn't copied.
+ *
+ * source: The source file to fill.
+ * data: The content of the source, it should stay valid until the source is closed.
+ * size: The size of the content.
+ */
+void open_source_buffer(struct source_file *source, const char *data, long size) {
+    source->data = (char *) data;
+    source->size = size;
+    source->is_mapped = false;
+    source->is_borrowed = true;
+    build_index(source);
+}
+
+/*
+ * Function: source_line_length
+ * ----------------------------
+ * Returns the length of a line of the source, including its '\n' (if it has one).
+ *
+ * source: The source file.
+ * index: The index of the line.
+ */
+int source_line_length(const struct source_file *source, int index) {
+    long end = index + 1 < source->lines_count ? source->line_starts[index + 1] : source->size;
+    return end - source->line_starts[index];
+}
+
+/*
+ * Function: close_source_file
+ * ---------------------------
+ * Releases the content of the source file and its index.
+ *
+ * source: The source file.
+ */
+void close_source_file(struct source_file *source) {
+    if (source->data != NULL && !source->is_borrowed) {
+        if (source->is_mapped) {
+            munmap(source->data, source->size);
+        } else {
+            free(source->data);
+        }
+    }
+    free(source->line_starts);
+    free(source->comment_starts);
+    source->data = NULL;
+    source->line_starts = NULL;
+    source->comment_starts = NULL;
+    source->lines_count = source->comments_count = 0;
+}
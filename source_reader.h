@@ -0,0 +1,32 @@
+#ifndef ASSEMBLER_SOURCE_READER_H
+#define ASSEMBLER_SOURCE_READER_H
+
+#include "utils.h"
+
+/*
+ * A source file (.as) loaded in memory, the file is mapped when possible and read otherwise.
+ * A source can also be a buffer of the caller (is_borrowed), which is never written or freed.
+ * The line index is built in one pass over the content (the commas are left to the lexer):
+ * line_starts[i] is the offset of the i-th line, comment_starts holds the offsets of the lines that
+ * start with ';' (in increasing order).
+ */
+struct source_file {
+    char *data;
+    long size;
+    bool is_mapped;
+    bool is_borrowed;
+
+    int *line_starts;
+    int lines_count;
+    int *comment_starts;
+    int comments_count;
+};
+
+long source_file_size(const char *file_name);
+bool open_source_file(struct source_file *source, const char *file_name);
+bool open_source_fd(struct source_file *source, int fd);
+void open_source_buffer(struct source_file *source, const char *data, long size);
+int source_line_length(const struct source_file *source, int index);
+void close_source_file(struct source_file *source);
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * A lock-free single-producer single-consumer ring, see spsc_ring.h.
+ * The indices only grow, the slot of an index is index & mask. A thread that finds the ring full (or empty)
+ * spins for a while and then yields the processor until the other thread moves.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include "spsc_ring.h"
+
+#define SPINS_BEFORE_YIELD 64
+
+/*
+ * Without the atomic builtins of GCC the indices are read and written as volatile, which orders them on x86 only.
+ */
+#if defined(__GNUC__)
+#define LOAD_ACQUIRE(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#else
+#define LOAD_ACQUIRE(index) (*(volatile unsigned long *) &(index))
+#define STORE_RELEASE(index, value) (*(volatile unsigned long *) &(index) = (value))
+#endif
+
+/*
+ * Function: init_spsc_ring
+ * ------------------------
+ * Initializes an empty ring.
+ *
+ * ring: The ring.
+ * capacity: The amount of slots, a power of 2.
+ */
+void init_spsc_ring(struct spsc_ring *ring, int capacity) {
+    ring->slots = (void **) malloc(capacity * sizeof(void *));
+    if (ring->slots == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+
+    ring->mask = (unsigned long) capacity - 1;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+/*
+ * Function: free_spsc_ring
+ * ------------------------
+ * Frees the slots of a ring, the items aren't freed.
+ *
+ * ring: The ring.
+ */
+void free_spsc_ring(struct spsc_ring *ring) {
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+/*
+ * Function: wait_a_moment
+ * -----------------------
+ * Waits for the other thread of a ring: spins first, and yields the processor after SPINS_BEFORE_YIELD tries.
+ *
+ * tries: The amount of tries so far, counted by the caller.
+ */
+static void wait_a_moment(int *tries) {
+    if (++*tries >= SPINS_BEFORE_YIELD) {
+        sched_yield();
+    }
+}
+
+/*
+ * Function: push_to_ring
+ * ----------------------
+ * Adds an item to the ring, waits while the ring is full. Called only from the producer.
+ *
+ * ring: The ring.
+ * item: The item.
+ */
+void push_to_ring(struct spsc_ring *ring, void *item) {
+    unsigned long tail = ring->tail;
+    int tries = 0;
+
+    while (tail - LOAD_ACQUIRE(ring->head) > ring->mask) {
+        wait_a_moment(&tries);
+    }
+
+    ring->slots[tail & ring->mask] = item;
+    STORE_RELEASE(ring->tail, tail + 1);
+}
+
+/*
+ * Function: pop_from_ring
+ * -----------------------
+ * Takes the oldest item of the ring, waits while the ring is empty. Called only from the consumer.
+ *
+ * ring: The ring.
+ *
+ * returns: The item.
+ */
+void *pop_from_ring(struct spsc_ring *ring) {
+    unsigned long head = ring->head;
+    void *item;
+    int tries = 0;
+
+    while (LOAD_ACQUIRE(ring->tail) == head) {
+        wait_a_moment(&tries);
+    }
+
+    item = ring->slots[head & ring->mask];
+    STORE_RELEASE(ring->head, head + 1);
+
+    return item;
+}
@@ -0,0 +1,29 @@
+#ifndef ASSEMBLER_SPSC_RING_H
+#define ASSEMBLER_SPSC_RING_H
+
+/*
+ * The size the head and the tail of a ring are padded to, so the producer and the consumer don't share a cache line.
+ */
+#define CACHE_LINE_SIZE 64
+
+/*
+ * A bounded ring of pointers between a single producer thread and a single consumer thread.
+ * Only the consumer writes head (the next slot to pop) and only the producer writes tail (the next slot to push),
+ * so no lock is needed: an index is published with a release store and read with an acquire load.
+ */
+struct spsc_ring {
+    void **slots;
+    unsigned long mask;
+    char head_padding[CACHE_LINE_SIZE];
+    unsigned long head;
+    char tail_padding[CACHE_LINE_SIZE];
+    unsigned long tail;
+    char end_padding[CACHE_LINE_SIZE];
+};
+
+void init_spsc_ring(struct spsc_ring *ring, int capacity);
+void free_spsc_ring(struct spsc_ring *ring);
+void push_to_ring(struct spsc_ring *ring, void *item);
+void *pop_from_ring(struct spsc_ring *ring);
+
+#endif
@@ -1,263 +1,271 @@
-/*
- * This code includes functions for manipulating a symbol table implemented as a linked list.
- */
-
-#include <malloc.h>
-#include <stdio.h>
-#include "symbol_table.h"
-
-/*
- * Function: free_symbol_list
- * --------------------------
- * Frees the memory allocated for the symbol list.
- *
- * list: Pointer to the symbol list pointer.
- */
-void free_symbol_list(struct symbol_list **list){
-    struct symbol_list *current = *list;
-    while (current != NULL){
-        struct symbol_list *temp = current;
-        current = current->next;
-        free(temp);
-    }
-    *list = NULL;
-}
-
-/*
- * Function: marge_list
- * --------------------
- * Merges two symbol lists together.
- *
- * list1: Pointer to the first symbol list.
- * list2: Pointer to the second symbol list.
- * amount_of_coded_lines_in_list1: The amount of coded lines in the first list (used for updating labels' indexes).
- */
-int marge_list(struct symbol_list *list1, struct symbol_list *list2, int amount_of_coded_lines_in_list1){
-    struct symbol_list *q = list2;
-    struct symbol_list *temp_symbol;
-    int error_counter = 0;
-
-    while (q != NULL){
-        temp_symbol = (struct symbol_list *)malloc(sizeof (struct symbol_list));
-        temp_symbol->symbol = malloc(sizeof (struct symbol));
-        temp_symbol->next = NULL;
-
-        temp_symbol->symbol->outsource_type = q->symbol->outsource_type;
-        temp_symbol->symbol->appearance_type = q->symbol->appearance_type;
-        temp_symbol->symbol->labels_index = q->symbol->labels_index + amount_of_coded_lines_in_list1;
-        strcpy(temp_symbol->symbol->label, q->symbol->label);
-
-        error_counter += add_to_symbol_list(list1, temp_symbol);
-        q = q->next;
-
-    }
-    /*
-    free(temp_symbol->symbol);
-    free(temp_symbol);
-     */
-
-    return error_counter;
-}
-
-/*
- * Function: get_symbol
- * --------------------
- * Retrieves a symbol from the symbol list based on the label.
- *
- * first: The first symbol in the symbol list.
- * label: The label of the symbol to retrieve.
- *
- * returns: A pointer to the symbol list node containing the symbol, or NULL if not found.
- */
-struct symbol_list* get_symbol(struct symbol_list *first, char *label){
-    struct symbol_list *current = first;
-
-    while (current != NULL && current->symbol != NULL){
-        if(strcmp(current->symbol->label, label) == 0){
-            return current;
-        }
-        current = current->next;
-    }
-
-    return NULL;
-}
-
-/*
- * Function: add_to_list
- * ---------------------
- * Adds a symbol to the symbol list.
- *
- * head: The head of the symbol list.
- * new_symbol: The symbol to be added.
- */
-void add_to_list(struct symbol_list *head, struct symbol_list *new_symbol){
-    if(head->symbol == NULL){
-        head->symbol = new_symbol->symbol;
-    }
-    else{
-        while(head->next != NULL)
-            head= head->next;
-        head->next = new_symbol;
-    }
-}
-
-/*
- * Function: index_of_label
- * ------------------------
- * Retrieves the index of a label in the symbol list.
- *
- * list: The symbol list.
- * label: The label to find the index for.
- *
- * returns: The index of the label in the symbol list, or -1 if not found.
- */
-int index_of_label(struct symbol_list *list, char *label){
-    struct symbol_list *res = get_symbol(list, label);
-    if(res != NULL &&
-    (res->symbol->appearance_type == declaration || res->symbol->outsource_type == ext)){
-        return res->symbol->labels_index;
-    } else if(res != NULL){
-        return index_of_label(res->next, label);
-    }
-
-    return -1;
-}
-
-/*
- * Function: update_as_external
- * ----------------------------
- * Updates symbols in the symbol list as external based on the external list.
- *
- * symbol_list: The symbol list to update.
- * external_list: The list of external symbols.
- */
-int update_as_external(struct symbol_list *symbol_list, struct symbol_list *external_list){
-    struct symbol_list *current_ext = external_list;
-    struct symbol_list *current = symbol_list;
-
-    int error_counter = 0;
-
-    while (current_ext != NULL && current_ext->symbol != NULL){
-        current = symbol_list;
-
-        while (current != NULL && current_ext->symbol != NULL){
-            if(current->symbol->outsource_type == ent &&
-               strcmp(current->symbol->label, current_ext->symbol->label) == 0){
-                printf("ERROR LABEL: %s IS BOTH EXTERNAL AND ENTRY\n", current->symbol->label);
-                error_counter++;
-            }
-            else if(current->symbol->appearance_type == declaration &&
-                    strcmp(current->symbol->label, current_ext->symbol->label) == 0){
-                printf("ERROR LABEL: %s IS BOTH EXTERNAL AND DECLARED\n", current->symbol->label);
-                error_counter++;
-            }
-            else if(strcmp(current_ext->symbol->label, current->symbol->label) == 0){
-                current->symbol->outsource_type = ext;
-            }
-
-            current = current->next;
-        }
-
-        current_ext = current_ext->next;
-    }
-
-    return error_counter;
-}
-
-/*
- * Function: add_to_external_symbol_list
- * -------------------------------------
- * Adds a symbol to the list of external symbols.
- *
- * first: The first symbol in the external symbol list.
- * new_symbol: The symbol to be added.
- */
-int add_to_external_symbol_list(struct symbol_list *first, struct symbol_list *new_symbol){
-    struct symbol_list *current;
-    int error_counter = 0;
-
-    if(first == NULL || first->symbol == NULL){
-        add_to_list(first, new_symbol);
-        return error_counter;
-    }
-
-    current = get_symbol(first, new_symbol->symbol->label);
-
-    if(current != NULL && current->symbol != NULL){
-        printf("ERROR LABEL: %s DEFINE TWICE AS EXTERNAL\n", current->symbol->label);
-        error_counter++;
-    } else {
-        current = first;
-        while (current->next != NULL){
-            current = current->next;
-        }
-        current->next = new_symbol;
-    }
-
-    return error_counter;
-}
-
-/*
- * Function: add_to_symbol_list
- * ----------------------------
- * Adds a symbol to the symbol list.
- *
- * first: The first symbol in the symbol list.
- * new_symbol: The symbol to be added.
- */
-int add_to_symbol_list(struct symbol_list *first, struct symbol_list *new_symbol) {
-    struct symbol_list *current;
-    int error_counter = 0;
-
-    if(first->symbol == NULL || new_symbol->symbol->appearance_type == usage){
-        add_to_list(first, new_symbol);
-    }
-    else if(new_symbol->symbol->appearance_type == declaration){
-        current = first;
-        while (current != NULL){
-            if(current->symbol->appearance_type == declaration &&
-               strcmp(current->symbol->label, new_symbol->symbol->label) == 0){
-                printf("ERROR LABEL: \"%s\" DECLARED TWICE\n", current->symbol->label);
-                error_counter++;
-                break;
-            }
-
-            if(strcmp(current->symbol->label, new_symbol->symbol->label) == 0 &&
-               current->symbol->outsource_type == ent){
-                current->symbol->appearance_type = declaration;
-                current->symbol->labels_index = new_symbol->symbol->labels_index;
-                break;
-            }
-
-            current = current->next;
-        }
-        if(current == NULL){
-            add_to_list(first, new_symbol);
-        }
-
-    }
-    else if(new_symbol->symbol->outsource_type == ent){
-        current = first;
-        while (current != NULL){
-            if(strcmp(current->symbol->label, new_symbol->symbol->label) == 0 &&
-               current->symbol->outsource_type == ent){
-                printf("ERROR LABEL: %s DECLARED TWICE AS ENTRY\n", current->symbol->label);
-                error_counter++;
-                break;
-            }
-
-            if(strcmp(current->symbol->label, new_symbol->symbol->label) == 0 &&
-               current->symbol->appearance_type == declaration){
-                current->symbol->outsource_type = ent;
-                break;
-            }
-
-            current = current->next;
-        }
-        if(current == NULL){
-            add_to_list(first, new_symbol);
-        }
-    }
-
-    return error_counter;
-}
+/*
+ * This code includes functions for manipulating a symbol table, indexed by the ids of the labels in the intern pool.
+ * Every symbol appears once in the table: its declaration, whether it's an entry or external, and the words that use it.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "symbol_table.h"
+
+/*
+ * Function: init_symbol_table
+ * ---------------------------
+ * Initializes an empty symbol table.
+ *
+ * table: The symbol table.
+ * names: The pool of the labels.
+ * diagnostics: Where the errors of the labels are reported.
+ */
+void init_symbol_table(struct symbol_table *table, const struct intern_pool *names, struct diagnostics *diagnostics){
+    table->symbols = NULL;
+    table->symbols_count = 0;
+    table->symbols_capacity = 0;
+    table->names = names;
+    table->diagnostics = diagnostics;
+}
+
+/*
+ * Function: free_symbol_table
+ * ---------------------------
+ * Frees the memory allocated for the symbol table.
+ *
+ * table: The symbol table.
+ */
+void free_symbol_table(struct symbol_table *table){
+    free(table->symbols);
+
+    table->symbols = NULL;
+    table->symbols_count = 0;
+    table->symbols_capacity = 0;
+}
+
+/*
+ * Function: find_symbol
+ * ---------------------
+ * Retrieves a symbol from the symbol table based on the id of its label.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ *
+ * returns: A pointer to the symbol, or NULL if the label was never added to the table.
+ */
+const struct symbol *find_symbol(const struct symbol_table *table, int id){
+    return id < table->symbols_count ? &table->symbols[id] : NULL;
+}
+
+/*
+ * Function: get_symbol
+ * --------------------
+ * Retrieves a symbol from the symbol table, the table grows to hold it if needed.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ *
+ * returns: A pointer to the symbol, valid until the table grows.
+ */
+static struct symbol *get_symbol(struct symbol_table *table, int id){
+    struct symbol *symbol;
+
+    if(id >= table->symbols_capacity){
+        struct symbol *grown;
+
+        table->symbols_capacity = table->symbols_capacity == 0 ? 32 : table->symbols_capacity;
+        while (id >= table->symbols_capacity){
+            table->symbols_capacity *= 2;
+        }
+        grown = (struct symbol *) realloc(table->symbols, table->symbols_capacity * sizeof(struct symbol));
+        if(grown == NULL){
+            printf("Error: Memory allocation failed.\n");
+            exit(-1);
+        }
+        table->symbols = grown;
+    }
+
+    for (; table->symbols_count <= id; table->symbols_count++) {
+        symbol = &table->symbols[table->symbols_count];
+        symbol->labels_index = -1;
+        symbol->is_declared = false;
+        symbol->is_data = false;
+        symbol->is_entry = false;
+        symbol->is_extern = false;
+        symbol->uses_count = 0;
+        symbol->pending_uses = -1;
+    }
+
+    return &table->symbols[id];
+}
+
+/*
+ * Function: add_symbol_declaration
+ * --------------------------------
+ * Adds the declaration of a label.
+ *
+ * table: The symbol table.
+ * id: The id of the declared label.
+ * index: The index of the word the label points to, in its coded list.
+ * is_data: If the label is declared on a directive, so its index is in the directives coded list.
+ *
+ * returns: The number of errors found.
+ */
+int add_symbol_declaration(struct symbol_table *table, int id, int index, bool is_data){
+    struct symbol *symbol = get_symbol(table, id);
+
+    if(symbol->is_declared){
+        report_error(table->diagnostics, "ERROR LABEL: \"%s\" DECLARED TWICE", get_interned_name(table->names, id));
+        return 1;
+    }
+
+    symbol->is_declared = true;
+    symbol->is_data = is_data;
+    symbol->labels_index = index;
+
+    return 0;
+}
+
+/*
+ * Function: add_entry_symbol
+ * --------------------------
+ * Marks a label as an entry.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ *
+ * returns: The number of errors found.
+ */
+int add_entry_symbol(struct symbol_table *table, int id){
+    struct symbol *symbol = get_symbol(table, id);
+
+    if(symbol->is_entry){
+        report_error(table->diagnostics, "ERROR LABEL: %s DECLARED TWICE AS ENTRY", get_interned_name(table->names, id));
+        return 1;
+    }
+
+    symbol->is_entry = true;
+    return 0;
+}
+
+/*
+ * Function: add_external_symbol
+ * -----------------------------
+ * Marks a label as external.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ *
+ * returns: The number of errors found.
+ */
+int add_external_symbol(struct symbol_table *table, int id){
+    struct symbol *symbol = get_symbol(table, id);
+
+    if(symbol->is_extern){
+        report_error(table->diagnostics, "ERROR LABEL: %s DEFINE TWICE AS EXTERNAL", get_interned_name(table->names, id));
+        return 1;
+    }
+
+    symbol->is_extern = true;
+    return 0;
+}
+
+/*
+ * Function: add_symbol_usage
+ * --------------------------
+ * Counts a word that uses a label, the word itself is recorded as a fixup of the coded list.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ */
+void add_symbol_usage(struct symbol_table *table, int id){
+    get_symbol(table, id)->uses_count++;
+}
+
+/*
+ * Function: add_pending_use
+ * -------------------------
+ * Adds a fixup to the head of the chain of the fixups that wait for a label to be declared.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ * fixup_index: The index of the fixup.
+ *
+ * returns: The index of the previous head of the chain, -1 if the chain was empty.
+ */
+int add_pending_use(struct symbol_table *table, int id, int fixup_index){
+    struct symbol *symbol = get_symbol(table, id);
+    int previous = symbol->pending_uses;
+
+    symbol->pending_uses = fixup_index;
+    return previous;
+}
+
+/*
+ * Function: take_pending_uses
+ * ---------------------------
+ * Takes the chain of the fixups that wait for a label, the label is left without pending fixups.
+ *
+ * table: The symbol table.
+ * id: The id of the label.
+ *
+ * returns: The index of the head of the chain, -1 if the chain is empty.
+ */
+int take_pending_uses(struct symbol_table *table, int id){
+    struct symbol *symbol = get_symbol(table, id);
+    int head = symbol->pending_uses;
+
+    symbol->pending_uses = -1;
+    return head;
+}
+
+/*
+ * Function: resolve_symbols
+ * -------------------------
+ * Sets the final addresses of the symbols, once the length of the instructions is known,
+ * and checks that the symbols are used correctly:
+ * - An external label can't be declared or be an entry.
+ * - A used label, or an entry, must be declared or external.
+ *
+ * table: The symbol table.
+ * inst_length: The amount of words in the instructions coded list, the directives come after them.
+ * base_address: The address of the first word.
+ *
+ * returns: The number of errors found.
+ */
+int resolve_symbols(struct symbol_table *table, int inst_length, int base_address){
+    struct symbol *symbol;
+    int i, j, error_counter = 0;
+
+    for (i = 0; i < table->symbols_count; ++i) {
+        symbol = &table->symbols[i];
+
+        if(symbol->is_declared){
+            symbol->labels_index += base_address + (symbol->is_data ? inst_length : 0);
+        }
+    }
+
+    for (i = 0; i < table->symbols_count; ++i) {
+        symbol = &table->symbols[i];
+
+        if(symbol->is_extern && symbol->is_entry){
+            report_error(table->diagnostics, "ERROR LABEL: %s IS BOTH EXTERNAL AND ENTRY", get_interned_name(table->names, i));
+            error_counter++;
+        } else if(symbol->is_extern && symbol->is_declared){
+            report_error(table->diagnostics, "ERROR LABEL: %s IS BOTH EXTERNAL AND DECLARED", get_interned_name(table->names, i));
+            error_counter++;
+        }
+    }
+
+    for (i = 0; i < table->symbols_count; ++i) {
+        symbol = &table->symbols[i];
+
+        if(!symbol->is_declared && !symbol->is_extern){
+            /*
+             * Every usage of the label is an error, and so is the entry
+             */
+            for (j = 0; j < symbol->uses_count + symbol->is_entry; ++j) {
+                report_error(table->diagnostics, "ERROR LABEL: \"%s\" USED BUT NEVER DECLARED", get_interned_name(table->names, i));
+                error_counter++;
+            }
+        }
+    }
+
+    return error_counter;
+}
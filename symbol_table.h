@@ -1,36 +1,46 @@
-#ifndef ASSEMBLER_SYMBOL_TABLE_H
-#define ASSEMBLER_SYMBOL_TABLE_H
-
-#include "string.h"
-#include "utils.h"
-
-enum outsource_type{
-    ent = 1,
-    ext
-};
-
-enum appearance_type{
-    declaration = 1, usage
-};
-
-struct symbol{
-    char label[MAX_LABEL_SIZE];
-    int labels_index;
-    int outsource_type;
-    int appearance_type;
-};
-
-struct symbol_list{
-    struct symbol *symbol;
-    struct symbol_list *next;
-};
-
-int add_to_symbol_list(struct symbol_list *first, struct symbol_list *new_symbol);
-void free_symbol_list(struct symbol_list **list);
-int index_of_label(struct symbol_list *list, char *label);
-int add_to_external_symbol_list(struct symbol_list *first, struct symbol_list *new_symbol);
-int update_as_external(struct symbol_list *symbol_list, struct symbol_list *external_list);
-int marge_list(struct symbol_list *list1, struct symbol_list *list2, int amount_of_coded_lines_in_list1);
-
-
-#endif
+#ifndef ASSEMBLER_SYMBOL_TABLE_H
+#define ASSEMBLER_SYMBOL_TABLE_H
+
+#include "string.h"
+#include "utils.h"
+#include "intern_pool.h"
+#include "diagnostics.h"
+
+/*
+ * pending_uses is the head of the chain of the fixups that wait for the label in one-pass mode, -1 if there are none.
+ */
+struct symbol{
+    int labels_index;
+    bool is_declared;
+    bool is_data;
+    bool is_entry;
+    bool is_extern;
+    int uses_count;
+    int pending_uses;
+};
+
+/*
+ * The symbols are indexed by the ids the intern pool gave their labels, the names are kept only in the pool.
+ * The errors of the labels are reported to diagnostics.
+ */
+struct symbol_table{
+    struct symbol *symbols;
+    int symbols_count;
+    int symbols_capacity;
+    const struct intern_pool *names;
+    struct diagnostics *diagnostics;
+};
+
+void init_symbol_table(struct symbol_table *table, const struct intern_pool *names, struct diagnostics *diagnostics);
+void free_symbol_table(struct symbol_table *table);
+const struct symbol *find_symbol(const struct symbol_table *table, int id);
+int add_symbol_declaration(struct symbol_table *table, int id, int index, bool is_data);
+int add_entry_symbol(struct symbol_table *table, int id);
+int add_external_symbol(struct symbol_table *table, int id);
+void add_symbol_usage(struct symbol_table *table, int id);
+int add_pending_use(struct symbol_table *table, int id, int fixup_index);
+int take_pending_uses(struct symbol_table *table, int id);
+int resolve_symbols(struct symbol_table *table, int inst_length, int base_address);
+
+
+#endif
@@ -0,0 +1,49 @@
+#!/bin/sh
+#
+# Assembles every regression source of this directory one file at a time, then with every mode that
+# splits or reorders the work (-j2, --lex-ahead, --one-pass), and compares the outputs (every format)
+# and the messages with the ones of the serial run. Given the library check, it also compares the words,
+# the .ent and the .ext lines the library gives (from two threads at once) with the ones of the command line.
+#
+# usage: tests/check.sh path/to/assembler [path/to/library_check]
+
+ASSEMBLER=$1
+LIBRARY_CHECK=$2
+FORMATS=--format=base64,base16,bin,ihex,srec,rle,object
+WORK=$(mktemp -d)
+FAILED=0
+
+trap 'rm -rf "$WORK"' EXIT
+
+for SOURCE in "$(dirname "$0")"/*.as; do
+    NAME=$(basename "$SOURCE" .as)
+
+    if ! "$ASSEMBLER" $FORMATS - < "$SOURCE" > "$WORK/$NAME.out" 2> "$WORK/$NAME.err"; then
+        echo "FAIL $NAME: the serial run failed"
+        cat "$WORK/$NAME.err"
+        FAILED=1
+        continue
+    fi
+
+    for MODE in -j2 --lex-ahead --one-pass; do
+        if ! "$ASSEMBLER" $MODE $FORMATS - < "$SOURCE" > "$WORK/$NAME$MODE.out" 2> "$WORK/$NAME$MODE.err" ||
+           ! cmp -s "$WORK/$NAME.out" "$WORK/$NAME$MODE.out" || ! cmp -s "$WORK/$NAME.err" "$WORK/$NAME$MODE.err"; then
+            echo "FAIL $NAME: $MODE differs from the serial run"
+            FAILED=1
+        else
+            echo "ok   $NAME $MODE"
+        fi
+    done
+
+    if [ -n "$LIBRARY_CHECK" ]; then
+        if ! "$ASSEMBLER" --format=bin - < "$SOURCE" > "$WORK/$NAME.bin" 2> /dev/null ||
+           ! "$LIBRARY_CHECK" "$SOURCE" > "$WORK/$NAME.library" || ! cmp -s "$WORK/$NAME.bin" "$WORK/$NAME.library"; then
+            echo "FAIL $NAME: the library differs from the command line"
+            FAILED=1
+        else
+            echo "ok   $NAME library"
+        fi
+    fi
+done
+
+exit $FAILED
@@ -0,0 +1,16 @@
+; Macros, entries, externs and every kind of data, for the library check (tests/library_check.c)
+mcro m1
+inc @r3
+endmcro
+MAIN: mov @r1, LIST
+.entry MAIN
+.extern X
+jmp X
+m1
+LOOP: bne X
+.entry LOOP
+LIST: .data 7, -3
+.space 2
+STR: .string "ab"
+.entry STR
+stop
@@ -0,0 +1,195 @@
+/*
+ * Checks the library API: a source is assembled in memory by assemble_buffer on two threads at once,
+ * the two results must be the same, and the result is written as the sections "assembler --format=bin -"
+ * writes to its standard output (the words, the .ent lines and the .ext lines), so it can be compared
+ * with the output of the command line.
+ *
+ * usage: library_check file.as > sections
+ * The exit status is 1 if the source can't be read or the results of the threads differ.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../libassembler.h"
+
+#define CHECK_THREADS 2
+
+/*
+ * The work of a thread: the source it assembles, and its result.
+ */
+struct check_job {
+    const char *source;
+    long size;
+    struct assembler_result result;
+};
+
+/*
+ * Function: assemble_job
+ * ----------------------
+ * The thread of a job: assembles its source.
+ */
+static void *assemble_job(void *argument) {
+    struct check_job *job = (struct check_job *) argument;
+
+    assemble_buffer(job->source, job->size, NULL, &job->result);
+    return NULL;
+}
+
+/*
+ * Function: read_source
+ * ---------------------
+ * Reads a whole file into memory.
+ *
+ * returns: The content (freed with free), NULL if the file can't be read.
+ */
+static char *read_source(const char *file_name, long *size) {
+    FILE *file = fopen(file_name, "rb");
+    char *source;
+
+    if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (*size = ftell(file)) < 0) {
+        if (file != NULL) {
+            fclose(file);
+        }
+        return NULL;
+    }
+
+    rewind(file);
+    source = (char *) malloc(*size + 1);
+    if (source != NULL && fread(source, 1, *size, file) != (size_t) *size) {
+        free(source);
+        source = NULL;
+    }
+    fclose(file);
+    return source;
+}
+
+/*
+ * Function: is_same_symbols
+ * -------------------------
+ * Compares the entries or the externs of two results.
+ */
+static int is_same_symbols(const struct assembler_symbol *first, const struct assembler_symbol *second, int count) {
+    int i = 0;
+
+    for (; i < count; ++i) {
+        if (strcmp(first[i].name, second[i].name) != 0 || first[i].address != second[i].address) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Function: is_same_result
+ * ------------------------
+ * Compares two results: the words, the entries, the externs and the errors.
+ */
+static int is_same_result(const struct assembler_result *first, const struct assembler_result *second) {
+    int i = 0;
+
+    if (first->inst_length != second->inst_length || first->dir_length != second->dir_length ||
+        first->entries_count != second->entries_count || first->externs_count != second->externs_count ||
+        first->diagnostics_count != second->diagnostics_count || first->errors_count != second->errors_count) {
+        return 0;
+    }
+
+    for (; i < first->diagnostics_count; ++i) {
+        if (first->diagnostics[i].line != second->diagnostics[i].line ||
+            strcmp(first->diagnostics[i].message, second->diagnostics[i].message) != 0) {
+            return 0;
+        }
+    }
+
+    return (first->words == NULL ||
+            memcmp(first->words, second->words, (first->inst_length + first->dir_length) * sizeof(uint16_t)) == 0) &&
+           is_same_symbols(first->entries, second->entries, first->entries_count) &&
+           is_same_symbols(first->externs, second->externs, first->externs_count);
+}
+
+/*
+ * Function: write_symbols_section
+ * -------------------------------
+ * Writes the entries or the externs as a section of their lines, nothing if there are none.
+ */
+static void write_symbols_section(const char *name, const struct assembler_symbol *symbols, int count) {
+    char line[128];
+    size_t size = 0;
+    int i = 0;
+
+    for (; i < count; ++i) {
+        size += sprintf(line, "%s %d\n", symbols[i].name, symbols[i].address);
+    }
+    if (count == 0) {
+        return;
+    }
+
+    printf("%s %lu\n", name, (unsigned long) size);
+    for (i = 0; i < count; ++i) {
+        printf("%s %d\n", symbols[i].name, symbols[i].address);
+    }
+}
+
+/*
+ * Function: write_sections
+ * ------------------------
+ * Writes a result as the sections of the command line: the words as little-endian bytes, then the .ent
+ * and the .ext lines. A result with errors has no sections.
+ */
+static void write_sections(const struct assembler_result *result) {
+    int length = result->inst_length + result->dir_length, i = 0;
+
+    if (result->errors_count != 0) {
+        return;
+    }
+
+    printf("bin %d\n", length * 2);
+    for (; i < length; ++i) {
+        putchar(result->words[i] & 0xFF);
+        putchar(result->words[i] >> 8);
+    }
+
+    write_symbols_section("ent", result->entries, result->entries_count);
+    write_symbols_section("ext", result->externs, result->externs_count);
+}
+
+int main(int argc, char **argv) {
+    struct check_job jobs[CHECK_THREADS];
+    pthread_t threads[CHECK_THREADS];
+    char *source;
+    long size;
+    int i, status = 0;
+
+    if (argc != 2 || (source = read_source(argv[1], &size)) == NULL) {
+        fprintf(stderr, "usage: library_check file.as\n");
+        return 1;
+    }
+
+    for (i = 0; i < CHECK_THREADS; ++i) {
+        jobs[i].source = source;
+        jobs[i].size = size;
+        if (pthread_create(&threads[i], NULL, assemble_job, &jobs[i]) != 0) {
+            fprintf(stderr, "A thread can't be started\n");
+            return 1;
+        }
+    }
+    for (i = 0; i < CHECK_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 1; i < CHECK_THREADS; ++i) {
+        if (!is_same_result(&jobs[0].result, &jobs[i].result)) {
+            fprintf(stderr, "The results of the threads differ\n");
+            status = 1;
+        }
+    }
+
+    write_sections(&jobs[0].result);
+
+    for (i = 0; i < CHECK_THREADS; ++i) {
+        free_assembler_result(&jobs[i].result);
+    }
+    free(source);
+    return status;
+}
@@ -0,0 +1,628 @@
+; Adjacent .space lines in the first chunk and a .space in a later chunk, for the parallel first pass (-j2)
+MAIN: mov @r1, @r2
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+inc @r3
+A: .space 3
+.space 2
+.data 7
+.extern X0
+.extern X1
+.extern X2
+.extern X3
+.extern X4
+.extern X5
+.extern X6
+.extern X7
+.extern X8
+.extern X9
+.extern X10
+.extern X11
+.extern X12
+.extern X13
+.extern X14
+.extern X15
+.extern X16
+.extern X17
+.extern X18
+.extern X19
+.extern X20
+.extern X21
+.extern X22
+.extern X23
+.extern X24
+.extern X25
+.extern X26
+.extern X27
+.extern X28
+.extern X29
+.extern X30
+.extern X31
+.extern X32
+.extern X33
+.extern X34
+.extern X35
+.extern X36
+.extern X37
+.extern X38
+.extern X39
+.extern X40
+.extern X41
+.extern X42
+.extern X43
+.extern X44
+.extern X45
+.extern X46
+.extern X47
+.extern X48
+.extern X49
+.extern X50
+.extern X51
+.extern X52
+.extern X53
+.extern X54
+.extern X55
+.extern X56
+.extern X57
+.extern X58
+.extern X59
+.extern X60
+.extern X61
+.extern X62
+.extern X63
+.extern X64
+.extern X65
+.extern X66
+.extern X67
+.extern X68
+.extern X69
+.extern X70
+.extern X71
+.extern X72
+.extern X73
+.extern X74
+.extern X75
+.extern X76
+.extern X77
+.extern X78
+.extern X79
+.extern X80
+.extern X81
+.extern X82
+.extern X83
+.extern X84
+.extern X85
+.extern X86
+.extern X87
+.extern X88
+.extern X89
+.extern X90
+.extern X91
+.extern X92
+.extern X93
+.extern X94
+.extern X95
+.extern X96
+.extern X97
+.extern X98
+.extern X99
+.extern X100
+.extern X101
+.extern X102
+.extern X103
+.extern X104
+.extern X105
+.extern X106
+.extern X107
+.extern X108
+.extern X109
+.extern X110
+.extern X111
+.extern X112
+.extern X113
+.extern X114
+.extern X115
+.extern X116
+.extern X117
+.extern X118
+.extern X119
+.extern X120
+.extern X121
+.extern X122
+.extern X123
+.extern X124
+.extern X125
+.extern X126
+.extern X127
+.extern X128
+.extern X129
+.extern X130
+.extern X131
+.extern X132
+.extern X133
+.extern X134
+.extern X135
+.extern X136
+.extern X137
+.extern X138
+.extern X139
+.extern X140
+.extern X141
+.extern X142
+.extern X143
+.extern X144
+.extern X145
+.extern X146
+.extern X147
+.extern X148
+.extern X149
+.extern X150
+.extern X151
+.extern X152
+.extern X153
+.extern X154
+.extern X155
+.extern X156
+.extern X157
+.extern X158
+.extern X159
+.extern X160
+.extern X161
+.extern X162
+.extern X163
+.extern X164
+.extern X165
+.extern X166
+.extern X167
+.extern X168
+.extern X169
+.extern X170
+.extern X171
+.extern X172
+.extern X173
+.extern X174
+.extern X175
+.extern X176
+.extern X177
+.extern X178
+.extern X179
+.extern X180
+.extern X181
+.extern X182
+.extern X183
+.extern X184
+.extern X185
+.extern X186
+.extern X187
+.extern X188
+.extern X189
+.extern X190
+.extern X191
+.extern X192
+.extern X193
+.extern X194
+.extern X195
+.extern X196
+.extern X197
+.extern X198
+.extern X199
+.extern X200
+.extern X201
+.extern X202
+.extern X203
+.extern X204
+.extern X205
+.extern X206
+.extern X207
+.extern X208
+.extern X209
+.extern X210
+.extern X211
+.extern X212
+.extern X213
+.extern X214
+.extern X215
+.extern X216
+.extern X217
+.extern X218
+.extern X219
+.extern X220
+.extern X221
+.extern X222
+.extern X223
+.extern X224
+.extern X225
+.extern X226
+.extern X227
+.extern X228
+.extern X229
+.extern X230
+.extern X231
+.extern X232
+.extern X233
+.extern X234
+.extern X235
+.extern X236
+.extern X237
+.extern X238
+.extern X239
+.extern X240
+.extern X241
+.extern X242
+.extern X243
+.extern X244
+.extern X245
+.extern X246
+.extern X247
+.extern X248
+.extern X249
+.extern X250
+.extern X251
+.extern X252
+.extern X253
+.extern X254
+.extern X255
+.extern X256
+.extern X257
+.extern X258
+.extern X259
+.extern X260
+.extern X261
+.extern X262
+.extern X263
+.extern X264
+.extern X265
+.extern X266
+.extern X267
+.extern X268
+.extern X269
+.extern X270
+.extern X271
+.extern X272
+.extern X273
+.extern X274
+.extern X275
+.extern X276
+.extern X277
+.extern X278
+.extern X279
+.extern X280
+.extern X281
+.extern X282
+.extern X283
+.extern X284
+.extern X285
+.extern X286
+.extern X287
+.extern X288
+.extern X289
+.extern X290
+.extern X291
+.extern X292
+.extern X293
+.extern X294
+.extern X295
+.extern X296
+.extern X297
+.extern X298
+.extern X299
+.extern X300
+.extern X301
+.extern X302
+.extern X303
+.extern X304
+.extern X305
+.extern X306
+.extern X307
+.extern X308
+.extern X309
+.extern X310
+.extern X311
+.extern X312
+.extern X313
+.extern X314
+.extern X315
+.extern X316
+.extern X317
+.extern X318
+.extern X319
+.extern X320
+.extern X321
+.extern X322
+.extern X323
+.extern X324
+.extern X325
+.extern X326
+.extern X327
+.extern X328
+.extern X329
+.extern X330
+.extern X331
+.extern X332
+.extern X333
+.extern X334
+.extern X335
+.extern X336
+.extern X337
+.extern X338
+.extern X339
+.extern X340
+.extern X341
+.extern X342
+.extern X343
+.extern X344
+.extern X345
+.extern X346
+.extern X347
+.extern X348
+.extern X349
+.extern X350
+.extern X351
+.extern X352
+.extern X353
+.extern X354
+.extern X355
+.extern X356
+.extern X357
+.extern X358
+.extern X359
+.extern X360
+.extern X361
+.extern X362
+.extern X363
+.extern X364
+.extern X365
+.extern X366
+.extern X367
+.extern X368
+.extern X369
+.extern X370
+.extern X371
+.extern X372
+.extern X373
+.extern X374
+.extern X375
+.extern X376
+.extern X377
+.extern X378
+.extern X379
+.extern X380
+.extern X381
+.extern X382
+.extern X383
+.extern X384
+.extern X385
+.extern X386
+.extern X387
+.extern X388
+.extern X389
+.extern X390
+.extern X391
+.extern X392
+.extern X393
+.extern X394
+.extern X395
+.extern X396
+.extern X397
+.extern X398
+.extern X399
+.extern X400
+.extern X401
+.extern X402
+.extern X403
+.extern X404
+.extern X405
+.extern X406
+.extern X407
+.extern X408
+.extern X409
+.extern X410
+.extern X411
+.extern X412
+.extern X413
+.extern X414
+.extern X415
+.extern X416
+.extern X417
+.extern X418
+.extern X419
+.extern X420
+.extern X421
+.extern X422
+.extern X423
+.extern X424
+.extern X425
+.extern X426
+.extern X427
+.extern X428
+.extern X429
+.extern X430
+.extern X431
+.extern X432
+.extern X433
+.extern X434
+.extern X435
+.extern X436
+.extern X437
+.extern X438
+.extern X439
+.extern X440
+.extern X441
+.extern X442
+.extern X443
+.extern X444
+.extern X445
+.extern X446
+.extern X447
+.extern X448
+.extern X449
+.extern X450
+.extern X451
+.extern X452
+.extern X453
+.extern X454
+.extern X455
+.extern X456
+.extern X457
+.extern X458
+.extern X459
+.extern X460
+.extern X461
+.extern X462
+.extern X463
+.extern X464
+.extern X465
+.extern X466
+.extern X467
+.extern X468
+.extern X469
+.extern X470
+.extern X471
+.extern X472
+.extern X473
+.extern X474
+.extern X475
+.extern X476
+.extern X477
+.extern X478
+.extern X479
+.extern X480
+.extern X481
+.extern X482
+.extern X483
+.extern X484
+.extern X485
+.extern X486
+.extern X487
+.extern X488
+.extern X489
+.extern X490
+.extern X491
+.extern X492
+.extern X493
+.extern X494
+.extern X495
+.extern X496
+.extern X497
+.extern X498
+.extern X499
+.extern X500
+.extern X501
+.extern X502
+.extern X503
+.extern X504
+.extern X505
+.extern X506
+.extern X507
+.extern X508
+.extern X509
+.extern X510
+.extern X511
+.extern X512
+.extern X513
+.extern X514
+.extern X515
+.extern X516
+.extern X517
+.extern X518
+.extern X519
+.extern X520
+.extern X521
+.extern X522
+.extern X523
+.extern X524
+.extern X525
+.extern X526
+.extern X527
+.extern X528
+.extern X529
+.extern X530
+.extern X531
+.extern X532
+.extern X533
+.extern X534
+.extern X535
+.extern X536
+.extern X537
+.extern X538
+.extern X539
+.extern X540
+.extern X541
+.extern X542
+.extern X543
+.extern X544
+.extern X545
+.extern X546
+.extern X547
+.extern X548
+.extern X549
+.extern X550
+.extern X551
+.extern X552
+.extern X553
+.extern X554
+.extern X555
+.extern X556
+.extern X557
+.extern X558
+.extern X559
+.extern X560
+.extern X561
+.extern X562
+.extern X563
+.extern X564
+.extern X565
+.extern X566
+.extern X567
+.extern X568
+.extern X569
+.extern X570
+.extern X571
+.extern X572
+.extern X573
+.extern X574
+.extern X575
+.extern X576
+.extern X577
+.extern X578
+.extern X579
+.extern X580
+.extern X581
+.extern X582
+.extern X583
+.extern X584
+.extern X585
+.extern X586
+.extern X587
+.extern X588
+.extern X589
+.extern X590
+.extern X591
+.extern X592
+.extern X593
+.extern X594
+.extern X595
+.extern X596
+.extern X597
+.extern X598
+.extern X599
+B: .space 2
+.data 9
+stop
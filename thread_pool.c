@@ -0,0 +1,216 @@
+/*
+ * A work-stealing pool of POSIX threads, see thread_pool.h.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "thread_pool.h"
+#include "utils.h"
+
+/*
+ * The tasks of a worker: the owner takes tasks[head], a thief takes tasks[tail - 1].
+ */
+struct task_deque {
+    int *tasks;
+    int head;
+    int tail;
+    pthread_mutex_t lock;
+};
+
+struct worker {
+    struct thread_pool *pool;
+    int index;
+    pthread_t thread;
+};
+
+struct thread_pool {
+    struct task_deque *deques;
+    struct worker *workers;
+    int threads_count;
+
+    void (*run_task)(void *context, int task);
+    void *context;
+
+    bool *done;
+    pthread_mutex_t done_lock;
+    pthread_cond_t task_done;
+};
+
+/*
+ * Function: allocate
+ * ------------------
+ * Allocates memory, the program stops if the allocation fails.
+ */
+static void *allocate(size_t size) {
+    void *memory = malloc(size);
+
+    if (memory == NULL) {
+        printf("Error: Memory allocation failed.\n");
+        exit(-1);
+    }
+    return memory;
+}
+
+/*
+ * Function: take_task
+ * -------------------
+ * Takes a task from a deque, from its front for the owner and from its back for a thief.
+ *
+ * deque: The deque.
+ * is_owner: If the deque belongs to the worker that takes the task.
+ *
+ * returns: The task, -1 if the deque is empty.
+ */
+static int take_task(struct task_deque *deque, bool is_owner) {
+    int task = -1;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->head < deque->tail) {
+        task = is_owner ? deque->tasks[deque->head++] : deque->tasks[--deque->tail];
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return task;
+}
+
+/*
+ * Function: next_task
+ * -------------------
+ * Finds the next task of a worker: from its own deque, or stolen from the other workers in turn.
+ *
+ * returns: The task, -1 if all the deques are empty.
+ */
+static int next_task(struct thread_pool *pool, int index) {
+    int task = take_task(&pool->deques[index], true), i;
+
+    for (i = 1; task == -1 && i < pool->threads_count; ++i) {
+        task = take_task(&pool->deques[(index + i) % pool->threads_count], false);
+    }
+
+    return task;
+}
+
+/*
+ * Function: run_worker
+ * --------------------
+ * The loop of a worker thread: runs tasks until there are none left, and marks each of them as done.
+ */
+static void *run_worker(void *argument) {
+    struct worker *worker = (struct worker *) argument;
+    struct thread_pool *pool = worker->pool;
+    int task;
+
+    while ((task = next_task(pool, worker->index)) != -1) {
+        pool->run_task(pool->context, task);
+
+        pthread_mutex_lock(&pool->done_lock);
+        pool->done[task] = true;
+        pthread_cond_broadcast(&pool->task_done);
+        pthread_mutex_unlock(&pool->done_lock);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function: start_thread_pool
+ * ---------------------------
+ * Starts the workers of a pool. The tasks are dealt to the workers in turn, in the given order,
+ * so the tasks that come first in the order are started first.
+ *
+ * threads_count: The amount of workers.
+ * order: The tasks, in the order they should be started.
+ * tasks_count: The amount of tasks.
+ * run_task: Runs a task, called from the workers.
+ * context: Passed to run_task.
+ *
+ * returns: The pool.
+ */
+struct thread_pool *start_thread_pool(int threads_count, const int *order, int tasks_count,
+                                      void (*run_task)(void *context, int task), void *context) {
+    struct thread_pool *pool = (struct thread_pool *) allocate(sizeof(struct thread_pool));
+    struct task_deque *deque;
+    int i;
+
+    pool->threads_count = threads_count;
+    pool->run_task = run_task;
+    pool->context = context;
+    pool->deques = (struct task_deque *) allocate(threads_count * sizeof(struct task_deque));
+    pool->workers = (struct worker *) allocate(threads_count * sizeof(struct worker));
+    pool->done = (bool *) allocate(tasks_count * sizeof(bool));
+    pthread_mutex_init(&pool->done_lock, NULL);
+    pthread_cond_init(&pool->task_done, NULL);
+
+    for (i = 0; i < tasks_count; ++i) {
+        pool->done[i] = false;
+    }
+
+    for (i = 0; i < threads_count; ++i) {
+        deque = &pool->deques[i];
+        deque->tasks = (int *) allocate((tasks_count / threads_count + 1) * sizeof(int));
+        deque->head = 0;
+        deque->tail = 0;
+        pthread_mutex_init(&deque->lock, NULL);
+    }
+    for (i = 0; i < tasks_count; ++i) {
+        deque = &pool->deques[i % threads_count];
+        deque->tasks[deque->tail++] = order[i];
+    }
+
+    for (i = 0; i < threads_count; ++i) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        if (pthread_create(&pool->workers[i].thread, NULL, run_worker, &pool->workers[i]) != 0) {
+            printf("Error: Thread creation failed.\n");
+            exit(-1);
+        }
+    }
+
+    return pool;
+}
+
+/*
+ * Function: wait_for_task
+ * -----------------------
+ * Waits until a task is done.
+ *
+ * pool: The pool.
+ * task: The task.
+ */
+void wait_for_task(struct thread_pool *pool, int task) {
+    pthread_mutex_lock(&pool->done_lock);
+    while (!pool->done[task]) {
+        pthread_cond_wait(&pool->task_done, &pool->done_lock);
+    }
+    pthread_mutex_unlock(&pool->done_lock);
+}
+
+/*
+ * Function: join_thread_pool
+ * --------------------------
+ * Waits until all the tasks are done and frees the pool.
+ *
+ * pool: The pool.
+ */
+void join_thread_pool(struct thread_pool *pool) {
+    int i;
+
+    for (i = 0; i < pool->threads_count; ++i) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < pool->threads_count; ++i) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->done_lock);
+    pthread_cond_destroy(&pool->task_done);
+
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->done);
+    free(pool);
+}
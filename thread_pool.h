@@ -0,0 +1,17 @@
+#ifndef ASSEMBLER_THREAD_POOL_H
+#define ASSEMBLER_THREAD_POOL_H
+
+/*
+ * A pool of worker threads that runs a fixed set of independent tasks, identified by 0 to tasks_count - 1.
+ * Every worker has its own deque of tasks, dealt in the given order, and takes the tasks from its front.
+ * A worker whose deque is empty steals from the back of the deques of the other workers,
+ * and stops when all of them are empty (no tasks are added after the start).
+ */
+struct thread_pool;
+
+struct thread_pool *start_thread_pool(int threads_count, const int *order, int tasks_count,
+                                      void (*run_task)(void *context, int task), void *context);
+void wait_for_task(struct thread_pool *pool, int task);
+void join_thread_pool(struct thread_pool *pool);
+
+#endif